@@ -1,8 +1,14 @@
+// POSIX Functions Some Headers Use (mkstemp(), strdup(), st_mtim, ...). Every Header Includes This One Before Any System Header,
+// So Include The Library Before Your Own System Headers, Or Build With -D_POSIX_C_SOURCE=200809L.
+# if !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+    # define _POSIX_C_SOURCE 200809L
+# endif
 # include <GL/gl.h>
 # include <string.h>
 # include <stdint.h>
 # include <stdlib.h>
 # include <stdio.h>
+# include <limits.h>
 
 #define _LITYPES 1
 
@@ -35,6 +41,35 @@ typedef struct {
 // ImageData.
 typedef void * ImageData;
 
+// Row Callback. Decoders That Stream Their Output Call It Once For Every Row (Top To Bottom) After The Image Info Is Filled.
+// Returning 0 Keeps Decoding, VGL_ROW_STOP Stops Decoding Successfully, Any Other Value Aborts And Is Returned As The Error.
+typedef int (*vglRowCallback)(void * user, const vglImageData * image, GLsizei y, const GLvoid * row);
+# define VGL_ROW_STOP 1
+
+// Pass Callback. Progressive Decoders Call It After Every Pass With The Whole Image Refined So Far (`final` Is Set On The Last Pass).
+// Return Values Work Like vglRowCallback (VGL_ROW_STOP Keeps The Current Preview And Stops Refining).
+typedef int (*vglPassCallback)(void * user, const vglImageData * image, int pass, int final);
+
+// Shared Errors
+# define REGION_OUT_OF_BOUNDS_ERROR 0x801
+# define REGION_OUT_OF_MEM_ERROR 0x802
+
+// A Region Being Cut Out Of A Streamed Image (See vglRegionRow).
+struct vgl_region {
+    GLsizei x, y; // Top-Left Corner In Image Coordinates
+    GLsizei width, height; // Size Of The Region
+    GLsizei row_x; // Image Column Of The First Pixel Of Each Streamed Row (Non-Zero For Decoders That Crop Rows Themselves)
+    vglImageData * out; // Receives The Region
+};
+
+// An Image Being Box-Downsampled While It Streams (See vglScaleRow).
+struct vgl_scale {
+    GLsizei max_width, max_height; // The Output Fits In This Box
+    GLsizei factor; // Every Output Pixel Averages factor * factor Pixels (Set On The First Row)
+    void * sums; // Column Sums Of The Rows Being Averaged (uint32_t, Or uint64_t When They Could Overflow). Free It After Decoding.
+    vglImageData * out; // Receives The Downsampled Image
+};
+
 // Linked List Definition
 struct node_l {
     ImageData data;
@@ -49,6 +84,10 @@ void quickSort(uint32_t array[], size_t left, size_t right);
 uint32_t ReverseByteOrder_UINT32(uint32_t inp);
 uint32_t ReverseHexOrder_UINT32(uint32_t inp);
 uint16_t ReverseHexOrder_UINT16(uint16_t inp);
+GLsizeiptr vglPixelSize(const vglImageData * image);
+int vglRegionRow(void * user, const vglImageData * image, GLsizei y, const GLvoid * row);
+GLsizei vglScaleFactor(GLsizei width, GLsizei height, GLsizei max_width, GLsizei max_height);
+int vglScaleRow(void * user, const vglImageData * image, GLsizei y, const GLvoid * row);
 
 // Appends A Node To The Linked_List
 struct node_l * append(struct node_l * root, ImageData data, size_t  * len) {
@@ -130,3 +169,149 @@ uint16_t ReverseHexOrder_UINT16(uint16_t inp) {
     return ((inp & 0xff00) >> 12 |
             ((inp & 0x00ff) << 12));
 }
+
+// Size Of A Single Pixel In Bytes (From The format/type Pair).
+GLsizeiptr vglPixelSize(const vglImageData * image) {
+    GLsizeiptr components, size;
+    switch (image->format) {
+        case GL_RED: case GL_R: components = 1; break;
+        case GL_RG: components = 2; break;
+        case GL_RGB: components = 3; break;
+        case GL_RGBA: components = 4; break;
+        default: return 0;
+    }
+    switch (image->type) {
+        case GL_UNSIGNED_BYTE: size = 1; break;
+        case GL_UNSIGNED_SHORT: size = 2; break;
+        default: return 0;
+    }
+    return components * size;
+}
+
+// Non-Empty Region Starting Inside The First Quadrant, Whose End (x + width, y + height) Fits In A GLsizei
+static int vgl_region_valid(GLsizei x, GLsizei y, GLsizei width, GLsizei height) {
+    return x >= 0 && y >= 0 && width > 0 && height > 0 && width <= INT_MAX - x && height <= INT_MAX - y;
+}
+
+// Row Callback That Copies The Part Of Each Row Covered By A `struct vgl_region` Into `region->out`.
+// The Output Is Allocated On The Region's First Row And Decoding Is Stopped After Its Last One.
+int vglRegionRow(void * user, const vglImageData * image, GLsizei y, const GLvoid * row) {
+    struct vgl_region * region = (struct vgl_region *) user;
+    if(y < region->y)
+        return 0;
+
+    vglImageData * out = region->out;
+    GLsizeiptr pixel_size = vglPixelSize(image);
+    size_t line = (size_t) region->width * pixel_size;
+    if(y == region->y) {
+        if( !vgl_region_valid(region->x, region->y, region->width, region->height) ||
+           region->width > image->mip[0].width - region->x || region->height > image->mip[0].height - region->y)
+            return REGION_OUT_OF_BOUNDS_ERROR;
+
+        *out = *image;
+        out->mipmapCount = 1;
+        out->mip[0].width = region->width;
+        out->mip[0].height = region->height;
+        out->mip[0].depth = 0;
+        out->mip[0].mipStride = 0;
+        out->TextureTotalSize = line * region->height;
+        if((out->mip[0].data = malloc(out->TextureTotalSize)) == NULL)
+            return REGION_OUT_OF_MEM_ERROR;
+    }
+
+    memcpy((GLubyte *) out->mip[0].data + (size_t) (y - region->y) * line, (const GLubyte *) row + (size_t) (region->x - region->row_x) * pixel_size, line);
+    return (y == region->y + region->height - 1) ? VGL_ROW_STOP : 0;
+}
+
+// Smallest Integer Factor That Shrinks A width * height Image Into max_width * max_height
+GLsizei vglScaleFactor(GLsizei width, GLsizei height, GLsizei max_width, GLsizei max_height) {
+    GLsizei fx = max_width > 0 ? (width + max_width - 1) / max_width : 1;
+    GLsizei fy = max_height > 0 ? (height + max_height - 1) / max_height : 1;
+    GLsizei factor = fx > fy ? fx : fy;
+    return factor > 1 ? factor : 1;
+}
+
+// Adds `cols` Pixels' Worth Of Column Sums Into `total` (One Per Channel, channels <= 4)
+static inline void vgl_scale_total32(const uint32_t * sums, size_t cols, size_t channels, uint64_t total[4]) {
+    for(size_t x = 0; x < cols; ++x, sums += channels)
+        for(size_t c = 0; c < channels; ++c)
+            total[c] += sums[c];
+}
+
+static void vgl_scale_total64(const uint64_t * sums, size_t cols, size_t channels, uint64_t total[4]) {
+    for(size_t x = 0; x < cols; ++x, sums += channels)
+        for(size_t c = 0; c < channels; ++c)
+            total[c] += sums[c];
+}
+
+// Row Callback That Box-Downsamples The Streamed Image Into `scale->out` (ceil(width / factor) * ceil(height / factor),
+// Edge Pixels Average What's Left). Only One Row Of Sums Is Kept, The Full-Size Image Is Never Stored.
+// Each Row Is Added To Per-Column Sums (A Flat Loop The Compiler Vectorizes), Which Are Only Summed Across
+// Once Every `factor` Rows. 16-Bit Samples Are Big-Endian Both Ways.
+int vglScaleRow(void * user, const vglImageData * image, GLsizei y, const GLvoid * row) {
+    struct vgl_scale * scale = (struct vgl_scale *) user;
+    vglImageData * out = scale->out;
+    GLsizei width = image->mip[0].width, height = image->mip[0].height;
+    int wide = image->type == GL_UNSIGNED_SHORT;
+    size_t channels = (size_t) vglPixelSize(image) / (wide ? 2 : 1);
+    size_t samples = (size_t) width * channels;
+    if(y == 0) {
+        scale->factor = vglScaleFactor(width, height, scale->max_width, scale->max_height);
+        *out = *image;
+        out->mipmapCount = 1;
+        out->mip[0].width = (width + scale->factor - 1) / scale->factor;
+        out->mip[0].height = (height + scale->factor - 1) / scale->factor;
+        out->mip[0].depth = 0;
+        out->mip[0].mipStride = 0;
+        out->TextureTotalSize = (GLsizeiptr) out->mip[0].width * out->mip[0].height * vglPixelSize(image);
+        free(scale->sums);
+        scale->sums = calloc(samples, sizeof(uint64_t));
+        if((out->mip[0].data = malloc(out->TextureTotalSize)) == NULL || scale->sums == NULL)
+            return REGION_OUT_OF_MEM_ERROR;
+    }
+
+    // Accumulate. A Column Sums At Most `factor` Samples, Which Only Overflows 32 Bits For Huge Factors.
+    size_t factor = (size_t) scale->factor, out_width = (size_t) out->mip[0].width;
+    int sums64 = (uint64_t) factor * (wide ? 0xFFFF : 0xFF) > UINT32_MAX;
+    uint32_t * sums32 = (uint32_t *) scale->sums;
+    uint64_t * sums = (uint64_t *) scale->sums;
+    const GLubyte * p = (const GLubyte *) row;
+    if(sums64) {
+        for(size_t i = 0; i < samples; ++i)
+            sums[i] += wide ? ((uint32_t) p[2 * i] << 8 | p[2 * i + 1]) : p[i];
+    } else if(wide) {
+        for(size_t i = 0; i < samples; ++i)
+            sums32[i] += (uint32_t) p[2 * i] << 8 | p[2 * i + 1];
+    } else {
+        for(size_t i = 0; i < samples; ++i)
+            sums32[i] += p[i];
+    }
+
+    // Every `factor` Rows (Or At The Bottom) Average The Column Sums Into An Output Row
+    if((size_t) (y + 1) % factor != 0 && y != height - 1)
+        return 0;
+    size_t rows = (size_t) y % factor + 1, oy = (size_t) y / factor;
+    GLubyte * dst = (GLubyte *) out->mip[0].data + oy * out_width * channels * (wide ? 2 : 1);
+    for(size_t ox = 0; ox < out_width; ++ox) {
+        size_t x0 = ox * factor, cols = x0 + factor <= (size_t) width ? factor : (size_t) width - x0;
+        uint64_t count = (uint64_t) rows * cols, total[4] = { 0, 0, 0, 0 };
+        if(sums64)
+            vgl_scale_total64(sums + x0 * channels, cols, channels, total);
+        else switch(channels) { // Constant Channel Counts, So Each Copy Of The Loop Is Unrolled
+            case 1: vgl_scale_total32(sums32 + x0, cols, 1, total); break;
+            case 2: vgl_scale_total32(sums32 + x0 * 2, cols, 2, total); break;
+            case 3: vgl_scale_total32(sums32 + x0 * 3, cols, 3, total); break;
+            default: vgl_scale_total32(sums32 + x0 * 4, cols, 4, total); break;
+        }
+        for(size_t c = 0; c < channels; ++c) {
+            uint64_t value = (total[c] + count / 2) / count;
+            if(wide) {
+                dst[(ox * channels + c) * 2] = (GLubyte) (value >> 8);
+                dst[(ox * channels + c) * 2 + 1] = (GLubyte) value;
+            } else
+                dst[ox * channels + c] = (GLubyte) value;
+        }
+    }
+    memset(scale->sums, 0, samples * (sums64 ? sizeof(uint64_t) : sizeof(uint32_t)));
+    return 0;
+}
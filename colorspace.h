@@ -0,0 +1,153 @@
+// sRGB To Linear Conversion, For The Few Places That Really Need Linear Pixels On The CPU (Filtering, Mip Generation, Compositing).
+// Textures Don't: Upload sRGB Images With Their GL_SRGB8 / GL_SRGB8_ALPHA8 Formats And The GPU Linearizes Them For Free.
+// 8-Bit sRGB Becomes 16-Bit Linear (8 Bits Aren't Enough For Linear Darks) Through A 256 Entry Table,
+// Eight Samples At A Time With AVX2 Gathers When Compiled With -mavx2. Needs -lm.
+# ifndef _LITYPES
+    # include "image_types.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdlib.h>
+# include <stdint.h>
+# include <string.h>
+# include <math.h>
+# ifdef __AVX2__
+    # include <immintrin.h>
+# endif
+
+# define _LICOLOR 1
+
+// Errors
+# define LINEAR_NOT_SRGB_ERROR 0xD00 // Only GL_SRGB8 And GL_SRGB8_ALPHA8 Images Can Be Linearized
+# define LINEAR_OUT_OF_MEM_ERROR 0xD01
+
+// Streaming Stage. Linearizes Every Row And Hands It To `callback` (See vglLinearRow).
+typedef struct {
+    vglRowCallback callback;
+    void * user;
+    vglImageData info; // Image Info As `callback` Sees It
+    uint32_t table[512]; // Color Entries, Then Alpha Entries
+    uint16_t * row;
+} vglLinearStage;
+
+// Functions
+int vglIsSRGB(const vglImageData *image);
+void vglLinearTable(uint32_t table[512]);
+void vglLinearizeRow(const uint32_t table[512], const GLubyte *src, uint16_t *dst, size_t samples, int channels);
+int vglLinearize(const vglImageData *in, vglImageData *out);
+int vglLinearStageInit(vglLinearStage *stage, vglRowCallback callback, void * user);
+int vglLinearStageFree(vglLinearStage *stage);
+int vglLinearRow(void * user, const vglImageData * image, GLsizei y, const GLvoid * row);
+
+int vglIsSRGB(const vglImageData * image) {
+    return image->internalFormat == GL_SRGB8 || image->internalFormat == GL_SRGB8_ALPHA8;
+}
+
+// Builds The Table: [0, 256) Decodes sRGB Colors, [256, 512) Widens Linear Alpha.
+// Entries Are 16-Bit Big-Endian (In Memory), Like Every Other 16-Bit Image The Loaders Produce.
+void vglLinearTable(uint32_t table[512]) {
+    for(int i = 0; i < 256; ++i) {
+        double c = i / 255.0;
+        double linear = c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+        uint16_t values[2] = { (uint16_t) (linear * 65535.0 + 0.5), (uint16_t) (i * 257) };
+        for(int k = 0; k < 2; ++k) {
+            uint8_t be[2] = { (uint8_t) (values[k] >> 8), (uint8_t) values[k] };
+            uint16_t stored;
+            memcpy(&stored, be, 2);
+            table[k * 256 + i] = stored;
+        }
+    }
+}
+
+// Linearizes `samples` Interleaved 8-Bit Samples With `channels` Channels (The Last One Is Alpha For 2 And 4).
+void vglLinearizeRow(const uint32_t table[512], const GLubyte * src, uint16_t * dst, size_t samples, int channels) {
+    size_t i = 0;
+    int has_alpha = channels == 2 || channels == 4;
+# ifdef __AVX2__
+    // 8 Lanes Hold Whole Pixels For 1, 2 And 4 Channels, So Alpha Sits In Fixed Lanes. RGB Has No Alpha.
+    __m256i alpha = _mm256_setzero_si256();
+    if(channels == 2)
+        alpha = _mm256_setr_epi32(0, 256, 0, 256, 0, 256, 0, 256);
+    else if(channels == 4)
+        alpha = _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256);
+    for(; i + 8 <= samples; i += 8) {
+        __m256i index = _mm256_add_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src + i))), alpha);
+        __m256i value = _mm256_i32gather_epi32((const int *) table, index, 4);
+        __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+        _mm_storeu_si128((__m128i *) (dst + i), packed);
+    }
+# endif
+    for(; i < samples; ++i)
+        dst[i] = (uint16_t) table[src[i] + ((has_alpha && i % channels == (size_t) channels - 1) ? 256 : 0)];
+}
+
+// Converts An sRGB Image Into A New 16-Bit Linear One (GL_RGB16 / GL_RGBA16). Every Mip And Slice Is Converted.
+// `in` Is Left Alone, Free `out` With free(out->mip[0].data).
+int vglLinearize(const vglImageData * in, vglImageData * out) {
+    if( !vglIsSRGB(in) )
+        return LINEAR_NOT_SRGB_ERROR;
+
+    int channels = in->format == GL_RGBA ? 4 : 3;
+    GLsizeiptr levels = in->mipmapCount > 0 ? in->mipmapCount : 1;
+    size_t layers = in->slices > 0 ? (size_t) in->slices : 1;
+    size_t total = 0, samples[MAX_TEXTURE_MIPS];
+    for(GLsizeiptr level = 0; level < levels; ++level) {
+        const vglImageMipData * mip = &in->mip[level];
+        samples[level] = (level == 0 && levels == 1) ? (size_t) in->TextureTotalSize
+                                                      : (size_t) mip->width * mip->height * (mip->depth > 0 ? mip->depth : 1) * channels * layers;
+        total += samples[level];
+    }
+
+    uint16_t * data = (uint16_t *) malloc(total * sizeof(uint16_t));
+    if( !data )
+        return LINEAR_OUT_OF_MEM_ERROR;
+    uint32_t table[512];
+    vglLinearTable(table);
+
+    *out = *in;
+    out->type = GL_UNSIGNED_SHORT;
+    out->internalFormat = channels == 4 ? GL_RGBA16 : GL_RGB16;
+    out->TextureTotalSize = in->TextureTotalSize * 2;
+    out->SliceStride = in->SliceStride * 2;
+    for(GLsizeiptr level = 0; level < levels; ++level) {
+        vglLinearizeRow(table, (const GLubyte *) in->mip[level].data, data, samples[level], channels);
+        out->mip[level].data = data;
+        out->mip[level].mipStride = in->mip[level].mipStride * 2;
+        data += samples[level];
+    }
+    return 0;
+}
+
+// Sets Up A Stage In Front Of `callback`: vglLoadRows(filename, &info, vglLinearRow, &stage).
+int vglLinearStageInit(vglLinearStage * stage, vglRowCallback callback, void * user) {
+    memset(stage, 0, sizeof(*stage));
+    stage->callback = callback;
+    stage->user = user;
+    vglLinearTable(stage->table);
+    return 0;
+}
+
+int vglLinearStageFree(vglLinearStage * stage) {
+    free(stage->row);
+    stage->row = NULL;
+    return 0;
+}
+
+// Row Callback That Linearizes sRGB Rows Before Passing Them On. Other Images Go Through Untouched.
+int vglLinearRow(void * user, const vglImageData * image, GLsizei y, const GLvoid * row) {
+    vglLinearStage * stage = (vglLinearStage *) user;
+    if( !vglIsSRGB(image) )
+        return stage->callback(stage->user, image, y, row);
+
+    int channels = image->format == GL_RGBA ? 4 : 3;
+    size_t samples = (size_t) image->mip[0].width * channels;
+    if(y == 0 || !stage->row) {
+        free(stage->row);
+        if((stage->row = (uint16_t *) malloc(samples * sizeof(uint16_t))) == NULL)
+            return LINEAR_OUT_OF_MEM_ERROR;
+        stage->info = *image;
+        stage->info.type = GL_UNSIGNED_SHORT;
+        stage->info.internalFormat = channels == 4 ? GL_RGBA16 : GL_RGB16;
+        stage->info.TextureTotalSize = image->TextureTotalSize * 2;
+    }
+    vglLinearizeRow(stage->table, (const GLubyte *) row, stage->row, samples, channels);
+    return stage->callback(stage->user, &stage->info, y, stage->row);
+}
@@ -0,0 +1,354 @@
+// Resumable Decode Jobs. A Job Decodes An Image A Few Rows At A Time Within A Time Budget, So A Render Thread Can
+// Stream Textures In Without Hitching: vglJobStart() Reads The Header And Allocates The Pixels, Every vglJobStep()
+// Decodes Rows Until Its Budget Runs Out, vglJobCancel() Drops The Job Anywhere In Between.
+// A vglJobQueue Orders Jobs By Caller-Assigned Priority And Spends A Per-Frame Budget On The Most Important Ones First.
+// Jobs And Queues Aren't Thread-Safe, Use Them From One Thread.
+# ifndef _LIIMAGE
+    # include "loadimage.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <setjmp.h>
+# include <time.h>
+
+# define _LIJOB 1
+
+// Job States
+# define VGL_JOB_RUNNING 0
+# define VGL_JOB_DONE 1 // `image` Is Complete And Belongs To The Caller
+# define VGL_JOB_FAILED 2 // `error` Says Why
+# define VGL_JOB_CANCELED 3
+
+// Errors
+# define JOB_OUT_OF_MEM_ERROR 0x1000
+# define JOB_NOT_RUNNING_ERROR 0x1001
+
+struct vgl_job_jpeg {
+    struct jpeg_decompress_struct cinfo;
+    struct readjpeg_error_mgr jerr;
+    int output; // Scanlines Are Being Read (Progressive Files Absorb Their Whole Input First)
+};
+
+struct vgl_job_qoi {
+    struct qoi_reader reader;
+    struct qoi_header hdr;
+    struct qoi_state state;
+};
+
+struct vgl_job_queue;
+
+typedef struct vgl_decode_job {
+    vglImageData image; // Info From vglJobStart(), Pixels Filled In As The Job Runs. Free With free(image.mip[0].data) Once Done.
+    int state;
+    int error;
+    int priority; // Higher Runs First (Change It Through vglQueueSetPriority() While Queued)
+    GLsizei rows, total; // Progress: Row Steps Done / Needed (Interlaced PNGs Count Every Adam7 Pass)
+    void * user;
+
+    // Decoder
+    int format;
+    FILE * fp;
+    size_t rowbytes;
+    png_structp png;
+    png_infop info;
+    struct vgl_job_jpeg * jpeg;
+    struct vgl_job_qoi * qoi;
+
+    struct vgl_job_queue * queue;
+    struct vgl_decode_job * prev, * next;
+} vglDecodeJob;
+
+// Called When A Queued Job Finishes Or Fails (It Has Already Left The Queue)
+typedef void (*vglJobCallback)(void * user, vglDecodeJob * job);
+
+typedef struct vgl_job_queue {
+    vglDecodeJob * head;
+    int count;
+    vglJobCallback callback;
+    void * user;
+} vglJobQueue;
+
+// Functions
+int vglJobStart(vglDecodeJob *job, char *filename, int priority);
+int vglJobStep(vglDecodeJob *job, long budget_us);
+int vglJobCancel(vglDecodeJob *job);
+int vglQueueInit(vglJobQueue *queue, vglJobCallback callback, void * user);
+int vglQueueAdd(vglJobQueue *queue, vglDecodeJob *job);
+int vglQueueSetPriority(vglJobQueue *queue, vglDecodeJob *job, int priority);
+int vglQueueCancel(vglJobQueue *queue, vglDecodeJob *job);
+int vglQueueRun(vglJobQueue *queue, long budget_us);
+int vglQueueDestroy(vglJobQueue *queue);
+
+static long vgl_job_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long) ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+// Releases The Decoder (Not The Pixels)
+static void vgl_job_release(vglDecodeJob * job) {
+    if(job->png)
+        png_destroy_read_struct(&job->png, &job->info, NULL);
+    if(job->jpeg) {
+        jpeg_destroy_decompress(&job->jpeg->cinfo);
+        free(job->jpeg);
+    }
+    free(job->qoi);
+    if(job->fp)
+        fclose(job->fp);
+    job->png = NULL;
+    job->info = NULL;
+    job->jpeg = NULL;
+    job->qoi = NULL;
+    job->fp = NULL;
+}
+
+// Ends A Job That Failed, Keeping The First Error
+static int vgl_job_fail(vglDecodeJob * job, int error) {
+    vgl_job_release(job);
+    free(job->image.mip[0].data);
+    job->image.mip[0].data = NULL;
+    job->state = VGL_JOB_FAILED;
+    job->error = error;
+    return error;
+}
+
+static int vgl_job_alloc(vglDecodeJob * job, size_t rowbytes) {
+    size_t height = (size_t) job->image.mip[0].height;
+    if(height && rowbytes > SIZE_MAX / height)
+        return JOB_OUT_OF_MEM_ERROR;
+    job->rowbytes = rowbytes;
+    job->image.TextureTotalSize = (GLsizeiptr) (rowbytes * height);
+    if((job->image.mip[0].data = malloc(rowbytes * height)) == NULL)
+        return JOB_OUT_OF_MEM_ERROR;
+    return 0;
+}
+
+static int vgl_job_start_png(vglDecodeJob * job) {
+    int res;
+    if((res = readpng_create(job->fp, &job->png, &job->info)))
+        return res;
+    if( setjmp(png_jmpbuf(job->png)) )
+        return PNG_READ_ERROR;
+    if((res = readpng_setup(&job->image, job->fp, job->png, job->info)))
+        return res;
+    job->total = job->image.mip[0].height * png_set_interlace_handling(job->png);
+    return vgl_job_alloc(job, png_get_rowbytes(job->png, job->info));
+}
+
+static int vgl_job_start_jpeg(vglDecodeJob * job) {
+    if((job->jpeg = (struct vgl_job_jpeg *) calloc(1, sizeof(*job->jpeg))) == NULL)
+        return JOB_OUT_OF_MEM_ERROR;
+    struct jpeg_decompress_struct * cinfo = &job->jpeg->cinfo;
+    cinfo->err = jpeg_std_error(&job->jpeg->jerr.pub);
+    job->jpeg->jerr.pub.error_exit = readjpeg_error_exit;
+    if( setjmp(job->jpeg->jerr.setjmp_buffer) )
+        return JPEG_READ_ERROR;
+    jpeg_create_decompress(cinfo);
+    jpeg_stdio_src(cinfo, job->fp);
+    jpeg_read_header(cinfo, TRUE);
+
+    // Progressive Files Would Absorb Their Whole Input Inside jpeg_start_decompress(),
+    // In Buffered-Image Mode That Happens In vglJobStep() Instead.
+    cinfo->buffered_image = jpeg_has_multiple_scans(cinfo);
+    readjpeg_start(&job->image, cinfo);
+    job->jpeg->output = !cinfo->buffered_image;
+    job->total = job->image.mip[0].height;
+    return vgl_job_alloc(job, (size_t) cinfo->output_width * cinfo->output_components);
+}
+
+static int vgl_job_start_qoi(vglDecodeJob * job) {
+    int res;
+    if((job->qoi = (struct vgl_job_qoi *) calloc(1, sizeof(*job->qoi))) == NULL)
+        return JOB_OUT_OF_MEM_ERROR;
+    job->qoi->reader.fp = job->fp;
+    if((res = readqoi_header(&job->qoi->reader, &job->qoi->hdr, &job->image)))
+        return res;
+    readqoi_state_init(&job->qoi->state);
+    job->total = job->image.mip[0].height;
+    return vgl_job_alloc(job, (size_t) job->qoi->hdr.width * job->qoi->hdr.channels);
+}
+
+// Opens `filename`, Reads Its Header And Allocates `job->image`. No Pixels Are Decoded Yet.
+int vglJobStart(vglDecodeJob * job, char * filename, int priority) {
+    memset(job, 0, sizeof(*job));
+    job->priority = priority;
+    if((job->fp = fopen(filename, "rb")) == NULL)
+        return vgl_job_fail(job, IMAGE_DOESNT_EXIST_ERROR);
+    unsigned char sig[8];
+    job->format = vglDetectFormat(sig, fread(sig, 1, sizeof(sig), job->fp));
+    rewind(job->fp);
+
+    int res = UNKNOWN_IMAGE_FORMAT_ERROR;
+    switch(job->format) {
+        case VGL_FORMAT_PNG: res = vgl_job_start_png(job); break;
+        case VGL_FORMAT_JPEG: res = vgl_job_start_jpeg(job); break;
+        case VGL_FORMAT_QOI: res = vgl_job_start_qoi(job); break;
+    }
+    return res ? vgl_job_fail(job, res) : 0;
+}
+
+// Interlaced PNGs Go Through Every Row Once Per Adam7 Pass, libpng Merges Each Pass Into The Same Rows
+static int vgl_job_step_png(vglDecodeJob * job, long deadline) {
+    if( setjmp(png_jmpbuf(job->png)) )
+        return PNG_READ_ERROR;
+    GLsizei height = job->image.mip[0].height;
+    do {
+        png_read_row(job->png, (png_bytep) job->image.mip[0].data + (size_t) (job->rows % height) * job->rowbytes, NULL);
+    } while(++job->rows < job->total && vgl_job_now_us() < deadline);
+    if(job->rows == job->total)
+        png_read_end(job->png, NULL);
+    return 0;
+}
+
+static int vgl_job_step_jpeg(vglDecodeJob * job, long deadline) {
+    struct jpeg_decompress_struct * cinfo = &job->jpeg->cinfo;
+    if( setjmp(job->jpeg->jerr.setjmp_buffer) )
+        return JPEG_READ_ERROR;
+
+    // Progressive Files: Absorb The Input (About An iMCU Row Per Call), Then Output The Final Scan
+    while( !job->jpeg->output ) {
+        int status = jpeg_consume_input(cinfo);
+        if(status == JPEG_SUSPENDED)
+            return JPEG_READ_ERROR; // stdio Sources Never Suspend, Unless The File Is Truncated
+        if(status == JPEG_REACHED_EOI) {
+            jpeg_start_output(cinfo, cinfo->input_scan_number);
+            job->jpeg->output = 1;
+        }
+        if(vgl_job_now_us() >= deadline)
+            return 0;
+    }
+
+    do {
+        JSAMPROW row_pointer = (JSAMPROW) job->image.mip[0].data + (size_t) cinfo->output_scanline * job->rowbytes;
+        jpeg_read_scanlines(cinfo, &row_pointer, 1);
+        job->rows = cinfo->output_scanline;
+    } while(job->rows < job->total && vgl_job_now_us() < deadline);
+
+    if(job->rows == job->total) {
+        if(cinfo->buffered_image)
+            jpeg_finish_output(cinfo);
+        jpeg_finish_decompress(cinfo);
+    }
+    return 0;
+}
+
+static int vgl_job_step_qoi(vglDecodeJob * job, long deadline) {
+    int res;
+    do {
+        uint8_t * row = (uint8_t *) job->image.mip[0].data + (size_t) job->rows * job->rowbytes;
+        if((res = readqoi_row(&job->qoi->reader, &job->qoi->hdr, &job->qoi->state, row)))
+            return res;
+    } while(++job->rows < job->total && vgl_job_now_us() < deadline);
+    return 0;
+}
+
+// Decodes Rows For About `budget_us` Microseconds (At Least One Row, The Budget Is Checked Between Rows).
+// Returns 0 Or The Decoder's Error. The Job Is VGL_JOB_DONE Once `rows` Reaches `total`.
+int vglJobStep(vglDecodeJob * job, long budget_us) {
+    if(job->state != VGL_JOB_RUNNING)
+        return job->state == VGL_JOB_FAILED ? job->error : JOB_NOT_RUNNING_ERROR;
+
+    long deadline = vgl_job_now_us() + budget_us;
+    int res = 0;
+    switch(job->format) {
+        case VGL_FORMAT_PNG: res = vgl_job_step_png(job, deadline); break;
+        case VGL_FORMAT_JPEG: res = vgl_job_step_jpeg(job, deadline); break;
+        case VGL_FORMAT_QOI: res = vgl_job_step_qoi(job, deadline); break;
+    }
+    if(res)
+        return vgl_job_fail(job, res);
+    if(job->rows == job->total) {
+        vgl_job_release(job);
+        job->state = VGL_JOB_DONE;
+    }
+    return 0;
+}
+
+// Stops A Running Job And Frees Everything It Holds, Pixels Included
+int vglJobCancel(vglDecodeJob * job) {
+    if(job->state != VGL_JOB_RUNNING)
+        return JOB_NOT_RUNNING_ERROR;
+    vgl_job_release(job);
+    free(job->image.mip[0].data);
+    job->image.mip[0].data = NULL;
+    job->state = VGL_JOB_CANCELED;
+    return 0;
+}
+
+int vglQueueInit(vglJobQueue * queue, vglJobCallback callback, void * user) {
+    memset(queue, 0, sizeof(*queue));
+    queue->callback = callback;
+    queue->user = user;
+    return 0;
+}
+
+// Queues A Started Job. The Job Must Stay At The Same Address Until It Leaves The Queue.
+int vglQueueAdd(vglJobQueue * queue, vglDecodeJob * job) {
+    if(job->state != VGL_JOB_RUNNING || job->queue)
+        return JOB_NOT_RUNNING_ERROR;
+    job->queue = queue;
+    job->prev = NULL;
+    job->next = queue->head;
+    if(queue->head)
+        queue->head->prev = job;
+    queue->head = job;
+    ++queue->count;
+    return 0;
+}
+
+static void vgl_queue_unlink(vglJobQueue * queue, vglDecodeJob * job) {
+    if(job->prev)
+        job->prev->next = job->next;
+    else
+        queue->head = job->next;
+    if(job->next)
+        job->next->prev = job->prev;
+    job->prev = job->next = NULL;
+    job->queue = NULL;
+    --queue->count;
+}
+
+// The Queue Is Unordered, The Next Job Is Picked When It's Needed. Changing A Priority Is Just A Store.
+int vglQueueSetPriority(vglJobQueue * queue, vglDecodeJob * job, int priority) {
+    if(job->queue != queue)
+        return JOB_NOT_RUNNING_ERROR;
+    job->priority = priority;
+    return 0;
+}
+
+// Removes And Cancels A Queued Job. The Callback Isn't Called.
+int vglQueueCancel(vglJobQueue * queue, vglDecodeJob * job) {
+    if(job->queue != queue)
+        return JOB_NOT_RUNNING_ERROR;
+    vgl_queue_unlink(queue, job);
+    return vglJobCancel(job);
+}
+
+// Spends About `budget_us` Microseconds Decoding, Highest Priority First (Ties Go To The Latest Queued).
+// Finished And Failed Jobs Leave The Queue And Are Passed To The Callback. Returns The Number Of Jobs Still Queued.
+int vglQueueRun(vglJobQueue * queue, long budget_us) {
+    long deadline = vgl_job_now_us() + budget_us;
+    for(long now = vgl_job_now_us(); queue->head && now < deadline; now = vgl_job_now_us()) {
+        vglDecodeJob * job = queue->head;
+        for(vglDecodeJob * it = job->next; it; it = it->next)
+            if(it->priority > job->priority)
+                job = it;
+
+        vglJobStep(job, deadline - now);
+        if(job->state != VGL_JOB_RUNNING) {
+            vgl_queue_unlink(queue, job);
+            if(queue->callback)
+                queue->callback(queue->user, job);
+        }
+    }
+    return queue->count;
+}
+
+// Cancels Everything Still Queued
+int vglQueueDestroy(vglJobQueue * queue) {
+    while(queue->head)
+        vglQueueCancel(queue, queue->head);
+    return 0;
+}
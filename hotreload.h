@@ -0,0 +1,310 @@
+// Hot Reloading For Content Iteration (Linux, Needs -pthread). A Background Thread Waits On inotify For The Files Behind
+// Loaded Images And Re-Decodes Only The Ones That Changed. The Caller Picks The New Pixels Up With vglReloadPoll(), On Its Own
+// Thread, Which Swaps Them Into The Watched vglImageData And Calls The Callback (To Re-Upload The Texture, ...).
+// The Buffer Swapped Out Is Kept For The Next Reload, So Edits That Keep The Size And Format Don't Allocate.
+// Directories Are Watched Rather Than Files, So Editors That Save Through A Rename Are Seen Too.
+# ifndef _LIIMAGE
+    # include "loadimage.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <limits.h>
+# include <unistd.h>
+# include <poll.h>
+# include <pthread.h>
+# include <sys/inotify.h>
+
+# define _LIRELOAD 1
+
+// Errors
+# define RELOAD_INIT_ERROR 0x1100 // inotify, The Wake-Up Pipe Or The Thread Couldn't Be Created
+# define RELOAD_WATCH_ERROR 0x1101 // The Directory Can't Be Watched
+# define RELOAD_OUT_OF_MEM_ERROR 0x1102
+# define RELOAD_NOT_WATCHED_ERROR 0x1103
+
+// Called From vglReloadPoll() For Every Reload. On Success `image` Already Holds The New Pixels (The Old Ones Are Gone),
+// On Failure (`error` Set, A Half-Saved File For Example) `image` Is Untouched.
+typedef void (*vglReloadCallback)(void * user, vglImageData * image, const char * filename, int error);
+
+typedef struct vgl_watch {
+    char * path;
+    const char * name; // File Name Inside The Watched Directory (Points Into `path`)
+    int wd;
+    vglImageData * image; // The Caller's Image
+    int dirty; // Changed On Disk Since The Last Decode Started
+    int busy; // Being Decoded (By The Background Thread, Outside The Lock)
+    int removed; // Unwatched While Busy, The Thread Frees It
+    int ready; // `staged` / `error` Wait For vglReloadPoll()
+    int error;
+    vglImageData staged;
+    void * spare; // Buffer To Decode The Next Reload Into
+    size_t spare_size;
+    struct vgl_watch * next;
+} vglWatch;
+
+typedef struct {
+    int fd; // inotify
+    int wake[2]; // Pipe That Stops The Thread
+    pthread_t thread;
+    pthread_mutex_t lock;
+    vglWatch * watches;
+    vglReloadCallback callback;
+    void * user;
+} vglReloader;
+
+// Functions
+int vglReloadInit(vglReloader *reloader, vglReloadCallback callback, void * user);
+int vglReloadWatch(vglReloader *reloader, const char *filename, vglImageData *image);
+int vglReloadUnwatch(vglReloader *reloader, vglImageData *image);
+int vglReloadPoll(vglReloader *reloader);
+int vglReloadDestroy(vglReloader *reloader);
+
+// Row Sink Reusing A Buffer When The Decoded Size Matches
+struct vgl_reload_sink {
+    vglImageData * out;
+    void * buffer;
+    size_t size;
+};
+
+static int vgl_reload_row(void * user, const vglImageData * image, GLsizei y, const GLvoid * row) {
+    struct vgl_reload_sink * sink = (struct vgl_reload_sink *) user;
+    size_t rowbytes = (size_t) image->mip[0].width * vglPixelSize(image);
+    if(y == 0) {
+        *sink->out = *image;
+        size_t size = rowbytes * image->mip[0].height;
+        if(size != sink->size || !sink->buffer) {
+            free(sink->buffer);
+            sink->size = 0;
+            if((sink->buffer = malloc(size)) == NULL)
+                return RELOAD_OUT_OF_MEM_ERROR;
+            sink->size = size;
+        }
+        sink->out->mip[0].data = sink->buffer;
+        sink->out->TextureTotalSize = (GLsizeiptr) size;
+    }
+    memcpy((GLubyte *) sink->buffer + (size_t) y * rowbytes, row, rowbytes);
+    return 0;
+}
+
+static void vgl_watch_free(vglWatch * watch) {
+    if(watch->ready && !watch->error)
+        free(watch->staged.mip[0].data);
+    free(watch->spare);
+    free(watch->path);
+    free(watch);
+}
+
+// Re-Decodes One Dirty Watch. Called With The Lock Held, Drops It While Decoding.
+static void vgl_reload_decode(vglReloader * reloader, vglWatch * watch) {
+    struct vgl_reload_sink sink = { NULL, watch->spare, watch->spare_size };
+    vglImageData image;
+    memset(&image, 0, sizeof(image));
+    sink.out = &image;
+    if(watch->ready && !watch->error) {
+        // A Reload Nobody Picked Up Yet. Decode Over It Instead.
+        free(sink.buffer);
+        sink.buffer = watch->staged.mip[0].data;
+        sink.size = (size_t) watch->staged.TextureTotalSize;
+        memset(&watch->staged, 0, sizeof(watch->staged));
+    }
+    watch->ready = 0;
+    watch->spare = NULL;
+    watch->spare_size = 0;
+    watch->dirty = 0;
+    watch->busy = 1;
+    pthread_mutex_unlock(&reloader->lock);
+
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    int res = vglLoadRows(watch->path, &info, vgl_reload_row, &sink);
+
+    pthread_mutex_lock(&reloader->lock);
+    watch->busy = 0;
+    if(watch->removed) {
+        free(sink.buffer);
+        vgl_watch_free(watch);
+        return;
+    }
+    if(res) {
+        watch->spare = sink.buffer;
+        watch->spare_size = sink.size;
+    } else
+        watch->staged = image;
+    watch->error = res;
+    watch->ready = 1;
+}
+
+// Background Thread: Marks Watches Dirty From inotify Events, Then Decodes Them
+static void * vgl_reload_thread(void * arg) {
+    vglReloader * reloader = (vglReloader *) arg;
+    union {
+        struct inotify_event event;
+        char bytes[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+    } buffer;
+
+    for(;;) {
+        struct pollfd fds[2] = { { reloader->fd, POLLIN, 0 }, { reloader->wake[0], POLLIN, 0 } };
+        if(poll(fds, 2, -1) < 0)
+            continue;
+        if(fds[1].revents)
+            return NULL;
+
+        ssize_t length;
+        while((length = read(reloader->fd, &buffer, sizeof(buffer))) > 0) {
+            pthread_mutex_lock(&reloader->lock);
+            for(char * p = buffer.bytes; p < buffer.bytes + length; ) {
+                struct inotify_event * event = (struct inotify_event *) p;
+                for(vglWatch * watch = reloader->watches; watch; watch = watch->next)
+                    if((event->mask & IN_Q_OVERFLOW) || (event->wd == watch->wd && event->len && strcmp(event->name, watch->name) == 0))
+                        watch->dirty = 1;
+                p += sizeof(struct inotify_event) + event->len;
+            }
+            pthread_mutex_unlock(&reloader->lock);
+        }
+
+        pthread_mutex_lock(&reloader->lock);
+        for(int found = 1; found; ) {
+            found = 0;
+            for(vglWatch * watch = reloader->watches; watch; watch = watch->next)
+                if(watch->dirty) {
+                    vgl_reload_decode(reloader, watch); // The List May Change While It Decodes, Start Over
+                    found = 1;
+                    break;
+                }
+        }
+        pthread_mutex_unlock(&reloader->lock);
+    }
+}
+
+int vglReloadInit(vglReloader * reloader, vglReloadCallback callback, void * user) {
+    memset(reloader, 0, sizeof(*reloader));
+    reloader->callback = callback;
+    reloader->user = user;
+    if((reloader->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0)
+        return RELOAD_INIT_ERROR;
+    if(pipe(reloader->wake) != 0) {
+        close(reloader->fd);
+        return RELOAD_INIT_ERROR;
+    }
+    pthread_mutex_init(&reloader->lock, NULL);
+    if(pthread_create(&reloader->thread, NULL, vgl_reload_thread, reloader) != 0) {
+        pthread_mutex_destroy(&reloader->lock);
+        close(reloader->wake[0]);
+        close(reloader->wake[1]);
+        close(reloader->fd);
+        return RELOAD_INIT_ERROR;
+    }
+    return 0;
+}
+
+// Starts Watching `filename`, Which `image` Was Loaded From. `image` Must Stay Put Until It's Unwatched
+// And Its Pixels Must Be free()able (Which Is What Every Loader Gives You).
+int vglReloadWatch(vglReloader * reloader, const char * filename, vglImageData * image) {
+    vglWatch * watch = (vglWatch *) calloc(1, sizeof(*watch));
+    if( !watch || (watch->path = strdup(filename)) == NULL ) {
+        free(watch);
+        return RELOAD_OUT_OF_MEM_ERROR;
+    }
+
+    char * slash = strrchr(watch->path, '/');
+    if(slash) {
+        *slash = '\0';
+        watch->wd = inotify_add_watch(reloader->fd, slash == watch->path ? "/" : watch->path, IN_CLOSE_WRITE | IN_MOVED_TO);
+        *slash = '/';
+        watch->name = slash + 1;
+    } else {
+        watch->wd = inotify_add_watch(reloader->fd, ".", IN_CLOSE_WRITE | IN_MOVED_TO);
+        watch->name = watch->path;
+    }
+    if(watch->wd < 0) {
+        vgl_watch_free(watch);
+        return RELOAD_WATCH_ERROR;
+    }
+
+    watch->image = image;
+    pthread_mutex_lock(&reloader->lock);
+    watch->next = reloader->watches;
+    reloader->watches = watch;
+    pthread_mutex_unlock(&reloader->lock);
+    return 0;
+}
+
+// Stops Watching `image` (Its Current Pixels Stay With It)
+int vglReloadUnwatch(vglReloader * reloader, vglImageData * image) {
+    pthread_mutex_lock(&reloader->lock);
+    vglWatch ** link = &reloader->watches;
+    while(*link && (*link)->image != image)
+        link = &(*link)->next;
+    vglWatch * watch = *link;
+    if( !watch ) {
+        pthread_mutex_unlock(&reloader->lock);
+        return RELOAD_NOT_WATCHED_ERROR;
+    }
+    *link = watch->next;
+
+    // inotify Hands Out One Descriptor Per Directory, Keep It While Other Files There Are Watched
+    int shared = 0;
+    for(vglWatch * other = reloader->watches; other; other = other->next)
+        shared |= other->wd == watch->wd;
+    if( !shared )
+        inotify_rm_watch(reloader->fd, watch->wd);
+
+    if(watch->busy)
+        watch->removed = 1;
+    else
+        vgl_watch_free(watch);
+    pthread_mutex_unlock(&reloader->lock);
+    return 0;
+}
+
+// Swaps Finished Reloads Into Their Images And Reports Them. Call It Where The Images Are Used (Once Per Frame).
+// The Callback May Watch And Unwatch Images. Returns The Number Of Reloads Reported.
+int vglReloadPoll(vglReloader * reloader) {
+    int reported = 0;
+    for(;;) {
+        pthread_mutex_lock(&reloader->lock);
+        vglWatch * watch = reloader->watches;
+        while(watch && !watch->ready)
+            watch = watch->next;
+        if( !watch ) {
+            pthread_mutex_unlock(&reloader->lock);
+            return reported;
+        }
+
+        vglImageData * image = watch->image;
+        int error = watch->error;
+        watch->ready = 0;
+        if( !error ) {
+            free(watch->spare);
+            watch->spare = image->mip[0].data;
+            watch->spare_size = (size_t) image->TextureTotalSize;
+            *image = watch->staged;
+            memset(&watch->staged, 0, sizeof(watch->staged)); // The Pixels Are The Caller's Now
+        }
+        char * filename = strdup(watch->path);
+        pthread_mutex_unlock(&reloader->lock);
+
+        if(reloader->callback)
+            reloader->callback(reloader->user, image, filename ? filename : "", error);
+        free(filename);
+        ++reported;
+    }
+}
+
+// Stops The Thread And Forgets Every Watch. The Images Keep Their Current Pixels.
+int vglReloadDestroy(vglReloader * reloader) {
+    char stop = 1;
+    if(write(reloader->wake[1], &stop, 1) == 1)
+        pthread_join(reloader->thread, NULL);
+    while(reloader->watches) {
+        vglWatch * watch = reloader->watches;
+        reloader->watches = watch->next;
+        vgl_watch_free(watch);
+    }
+    pthread_mutex_destroy(&reloader->lock);
+    close(reloader->wake[0]);
+    close(reloader->wake[1]);
+    close(reloader->fd);
+    return 0;
+}
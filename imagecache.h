@@ -0,0 +1,318 @@
+// Shared Decoded-Image Cache (Needs -pthread).
+// Images Are Keyed By Path (Plus Modification Time And Size) Or By Content Hash For Memory Blocks, Decoded Once
+// And Shared Through Refcounted Handles. Concurrent Requests For An Image Being Decoded Wait For That Decode
+// Instead Of Starting Their Own. Unreferenced Images Are Evicted Least Recently Used First Once The Cache
+// Holds More Than Its Byte Budget (Counted From TextureTotalSize). Referenced Images Are Never Evicted.
+# ifndef _LIIMAGE
+    # include "loadimage.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdlib.h>
+# include <string.h>
+# include <stdio.h>
+# include <pthread.h>
+# include <time.h>
+# include <sys/stat.h>
+# include <zlib.h>
+
+# define _LICACHE 1
+
+# define VGL_CACHE_BUCKETS 256
+# define VGL_CACHE_DEFAULT_BUDGET ((size_t) 256 << 20) // Budget Of The Process-Wide Cache Unless VGL_CACHE_BUDGET (In MB) Says Otherwise
+
+// Errors
+# define CACHE_OUT_OF_MEM_ERROR 0xE00
+# define CACHE_FILE_ERROR 0xE01 // stat() Failed
+
+// Entry States
+# define VGL_CACHE_LOADING 0
+# define VGL_CACHE_READY 1
+# define VGL_CACHE_FAILED 2
+
+// Cached Image. Handles Are Pointers To Entries, Read The Image With vglCacheImage().
+typedef struct vgl_cache_entry {
+    char * key; // Path, Or "#crc-adler-size" For Memory Blocks
+    struct timespec mtime; // Of The File When It Was Decoded
+    off_t size;
+    int refs; // Handles Out There (Plus One While Loading)
+    int state;
+    int error; // Loader Result When state Is VGL_CACHE_FAILED
+    int linked; // Still In The Table (Entries Replaced By A Newer File Are Unlinked And Freed With Their Last Handle)
+    size_t bytes;
+    vglImageData image;
+    struct vgl_cache_entry * next; // Hash Chain
+    struct vgl_cache_entry * lru_prev, * lru_next; // Most Recently Used First
+} vglCacheEntry;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t ready; // Broadcast Whenever A Decode Finishes
+    size_t budget, used;
+    size_t hits, misses;
+    vglCacheEntry * buckets[VGL_CACHE_BUCKETS];
+    vglCacheEntry * lru_head, * lru_tail;
+} vglImageCache;
+
+// Functions
+int vglCacheInit(vglImageCache *cache, size_t budget);
+int vglCacheDestroy(vglImageCache *cache);
+vglImageCache * vglDefaultCache(void);
+int vglCacheSetBudget(vglImageCache *cache, size_t budget);
+int vglCacheLoad(vglImageCache *cache, char *filename, vglCacheEntry **handle);
+int vglCacheLoadMemory(vglImageCache *cache, const void *data, size_t size, vglCacheEntry **handle);
+const vglImageData * vglCacheImage(const vglCacheEntry *handle);
+vglCacheEntry * vglCacheRetain(vglImageCache *cache, vglCacheEntry *handle);
+int vglCacheRelease(vglImageCache *cache, vglCacheEntry *handle);
+int vglCacheTrim(vglImageCache *cache);
+
+int vglCacheInit(vglImageCache * cache, size_t budget) {
+    memset(cache, 0, sizeof(*cache));
+    cache->budget = budget;
+    pthread_mutex_init(&cache->lock, NULL);
+    pthread_cond_init(&cache->ready, NULL);
+    return 0;
+}
+
+// Frees Every Image. No Handles May Be Used Afterwards.
+int vglCacheDestroy(vglImageCache * cache) {
+    for(int i = 0; i < VGL_CACHE_BUCKETS; ++i) {
+        vglCacheEntry * entry = cache->buckets[i];
+        while(entry) {
+            vglCacheEntry * next = entry->next;
+            free(entry->image.mip[0].data);
+            free(entry->key);
+            free(entry);
+            entry = next;
+        }
+    }
+    pthread_cond_destroy(&cache->ready);
+    pthread_mutex_destroy(&cache->lock);
+    memset(cache, 0, sizeof(*cache));
+    return 0;
+}
+
+static vglImageCache vgl_default_cache;
+static pthread_once_t vgl_default_cache_once = PTHREAD_ONCE_INIT;
+
+static void vgl_default_cache_init(void) {
+    size_t budget = VGL_CACHE_DEFAULT_BUDGET;
+    char * p;
+    if((p = getenv("VGL_CACHE_BUDGET")) != NULL)
+        budget = (size_t) strtoull(p, NULL, 10) << 20;
+    vglCacheInit(&vgl_default_cache, budget);
+}
+
+// The Process-Wide Cache (Never Destroyed)
+vglImageCache * vglDefaultCache(void) {
+    pthread_once(&vgl_default_cache_once, vgl_default_cache_init);
+    return &vgl_default_cache;
+}
+
+static size_t vgl_cache_hash(const char * key) {
+    size_t h = 5381;
+    while(*key)
+        h = h * 33 + (unsigned char) *key++;
+    return h % VGL_CACHE_BUCKETS;
+}
+
+static void vgl_cache_lru_unlink(vglImageCache * cache, vglCacheEntry * entry) {
+    if(entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+    else if(cache->lru_head == entry) cache->lru_head = entry->lru_next;
+    if(entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+    else if(cache->lru_tail == entry) cache->lru_tail = entry->lru_prev;
+    entry->lru_prev = entry->lru_next = NULL;
+}
+
+static void vgl_cache_lru_push(vglImageCache * cache, vglCacheEntry * entry) {
+    entry->lru_prev = NULL;
+    entry->lru_next = cache->lru_head;
+    if(cache->lru_head) cache->lru_head->lru_prev = entry;
+    cache->lru_head = entry;
+    if( !cache->lru_tail ) cache->lru_tail = entry;
+}
+
+// Takes An Entry Out Of The Table And The LRU List, Its Memory Stops Counting Against The Budget
+static void vgl_cache_unlink(vglImageCache * cache, vglCacheEntry * entry) {
+    if( !entry->linked )
+        return;
+    vglCacheEntry ** link = &cache->buckets[vgl_cache_hash(entry->key)];
+    while(*link != entry)
+        link = &(*link)->next;
+    *link = entry->next;
+    vgl_cache_lru_unlink(cache, entry);
+    if(entry->state == VGL_CACHE_READY)
+        cache->used -= entry->bytes;
+    entry->linked = 0;
+}
+
+static void vgl_cache_free(vglCacheEntry * entry) {
+    free(entry->image.mip[0].data);
+    free(entry->key);
+    free(entry);
+}
+
+// Evicts Unreferenced Images, Least Recently Used First, Until The Cache Fits Its Budget. Called With The Lock Held.
+static void vgl_cache_evict(vglImageCache * cache) {
+    vglCacheEntry * entry = cache->lru_tail;
+    while(entry && cache->used > cache->budget) {
+        vglCacheEntry * prev = entry->lru_prev;
+        if(entry->refs == 0) {
+            vgl_cache_unlink(cache, entry);
+            vgl_cache_free(entry);
+        }
+        entry = prev;
+    }
+}
+
+int vglCacheSetBudget(vglImageCache * cache, size_t budget) {
+    pthread_mutex_lock(&cache->lock);
+    cache->budget = budget;
+    vgl_cache_evict(cache);
+    pthread_mutex_unlock(&cache->lock);
+    return 0;
+}
+
+// Drops Every Unreferenced Image
+int vglCacheTrim(vglImageCache * cache) {
+    pthread_mutex_lock(&cache->lock);
+    size_t budget = cache->budget;
+    cache->budget = 0;
+    vgl_cache_evict(cache);
+    cache->budget = budget;
+    pthread_mutex_unlock(&cache->lock);
+    return 0;
+}
+
+// Finds Or Decodes The Image For `key`. `filename` Or `data` Says Where It Comes From.
+static int vgl_cache_get(vglImageCache * cache, const char * key, struct timespec mtime, off_t size, char * filename, const void * data, size_t data_size, vglCacheEntry ** handle) {
+    size_t bucket = vgl_cache_hash(key);
+    *handle = NULL;
+    pthread_mutex_lock(&cache->lock);
+
+    vglCacheEntry * entry = cache->buckets[bucket];
+    while(entry && strcmp(entry->key, key) != 0)
+        entry = entry->next;
+    if(entry && (entry->mtime.tv_sec != mtime.tv_sec || entry->mtime.tv_nsec != mtime.tv_nsec || entry->size != size)) {
+        // The File Changed Since It Was Decoded. Whoever Still Holds The Old Image Keeps It.
+        vgl_cache_unlink(cache, entry);
+        if(entry->refs == 0)
+            vgl_cache_free(entry);
+        entry = NULL;
+    }
+
+    if(entry) {
+        ++entry->refs;
+        ++cache->hits;
+        while(entry->state == VGL_CACHE_LOADING)
+            pthread_cond_wait(&cache->ready, &cache->lock);
+        int res = 0;
+        if(entry->state == VGL_CACHE_FAILED) {
+            res = entry->error;
+            if(--entry->refs == 0 && !entry->linked)
+                vgl_cache_free(entry);
+        } else {
+            if(entry->linked) {
+                vgl_cache_lru_unlink(cache, entry);
+                vgl_cache_lru_push(cache, entry);
+            }
+            *handle = entry;
+        }
+        pthread_mutex_unlock(&cache->lock);
+        return res;
+    }
+
+    // Miss: Publish A Loading Entry So Others Wait For Us, Then Decode Without The Lock
+    ++cache->misses;
+    entry = (vglCacheEntry *) calloc(1, sizeof(vglCacheEntry));
+    if( !entry || (entry->key = strdup(key)) == NULL) {
+        free(entry);
+        pthread_mutex_unlock(&cache->lock);
+        return CACHE_OUT_OF_MEM_ERROR;
+    }
+    entry->mtime = mtime;
+    entry->size = size;
+    entry->refs = 1;
+    entry->state = VGL_CACHE_LOADING;
+    entry->linked = 1;
+    entry->next = cache->buckets[bucket];
+    cache->buckets[bucket] = entry;
+    pthread_mutex_unlock(&cache->lock);
+
+    int res = filename ? vglLoad(filename, &entry->image) : vglLoadMemory(data, data_size, &entry->image);
+
+    pthread_mutex_lock(&cache->lock);
+    if(res) {
+        entry->state = VGL_CACHE_FAILED;
+        entry->error = res;
+        entry->image.mip[0].data = NULL;
+        vgl_cache_unlink(cache, entry); // Failures Aren't Cached, The Next Request Tries Again
+        if(--entry->refs == 0)
+            vgl_cache_free(entry);
+    } else {
+        entry->state = VGL_CACHE_READY;
+        entry->bytes = (size_t) entry->image.TextureTotalSize;
+        if(entry->linked) {
+            cache->used += entry->bytes;
+            vgl_cache_lru_push(cache, entry);
+            vgl_cache_evict(cache);
+        }
+        *handle = entry;
+    }
+    pthread_cond_broadcast(&cache->ready);
+    pthread_mutex_unlock(&cache->lock);
+    return res;
+}
+
+// Returns A Handle To The Decoded Image Of `filename`, Decoding It Only If It Isn't Cached (Or Changed On Disk).
+// Release The Handle With vglCacheRelease(). The Image Is Shared: Don't Modify Or Free It.
+int vglCacheLoad(vglImageCache * cache, char * filename, vglCacheEntry ** handle) {
+    struct stat st;
+    if(stat(filename, &st) != 0) {
+        *handle = NULL;
+        return CACHE_FILE_ERROR;
+    }
+    return vgl_cache_get(cache, filename, st.st_mtim, st.st_size, filename, NULL, 0, handle);
+}
+
+// Same As vglCacheLoad() For An Encoded Image In Memory, Keyed By Its Content (CRC-32, Adler-32 And Size).
+int vglCacheLoadMemory(vglImageCache * cache, const void * data, size_t size, vglCacheEntry ** handle) {
+    uLong crc = crc32(0L, Z_NULL, 0), adler = adler32(0L, Z_NULL, 0);
+    const Bytef * p = (const Bytef *) data;
+    for(size_t left = size; left > 0; ) {
+        uInt n = left > 0x40000000 ? 0x40000000 : (uInt) left;
+        crc = crc32(crc, p, n);
+        adler = adler32(adler, p, n);
+        p += n;
+        left -= n;
+    }
+    char key[64];
+    snprintf(key, sizeof(key), "#%08lx-%08lx-%zu", crc, adler, size);
+    struct timespec none = { 0, 0 };
+    return vgl_cache_get(cache, key, none, (off_t) size, NULL, data, size, handle);
+}
+
+const vglImageData * vglCacheImage(const vglCacheEntry * handle) {
+    return &handle->image;
+}
+
+// Takes Another Reference To A Handle (For Another Owner)
+vglCacheEntry * vglCacheRetain(vglImageCache * cache, vglCacheEntry * handle) {
+    pthread_mutex_lock(&cache->lock);
+    ++handle->refs;
+    pthread_mutex_unlock(&cache->lock);
+    return handle;
+}
+
+// Drops A Reference. The Image Stays Cached Until The Budget Needs Its Memory.
+int vglCacheRelease(vglImageCache * cache, vglCacheEntry * handle) {
+    if( !handle )
+        return 0;
+    pthread_mutex_lock(&cache->lock);
+    if(--handle->refs == 0) {
+        if( !handle->linked )
+            vgl_cache_free(handle);
+        else
+            vgl_cache_evict(cache);
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Format-Independent Loading Functions. Includes Every Loader.
+# ifndef _LITYPES
+    # include "image_types.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdio.h>
+# include <string.h>
+
+# ifndef _LIPNG
+    # include "loadpng.h"
+# endif
+# ifndef _LIJPEG
+    # include "loadjpeg.h"
+# endif
+# ifndef _LIQOI
+    # include "loadqoi.h"
+# endif
+
+# define _LIIMAGE 1
+
+// Formats
+# define VGL_FORMAT_UNKNOWN 0
+# define VGL_FORMAT_PNG 1
+# define VGL_FORMAT_JPEG 2
+# define VGL_FORMAT_QOI 3
+
+// Errors
+# define UNKNOWN_IMAGE_FORMAT_ERROR 0x800
+
+// Functions
+int vglDetectFormat(const unsigned char *sig, size_t len);
+int vglDetectFileFormat(char *filename);
+int vglLoad(char *filename, vglImageData *out);
+int vglLoadMemory(const void *data, size_t size, vglImageData *out);
+int vglLoadRegion(char *filename, GLsizei x, GLsizei y, GLsizei width, GLsizei height, vglImageData *out);
+int vglLoadScaled(char *filename, GLsizei max_width, GLsizei max_height, vglImageData *out);
+int vglLoadRows(char *filename, vglImageData *info, vglRowCallback callback, void * user);
+int vglLoadProgressive(char *filename, vglImageData *image, vglPassCallback callback, void * user);
+
+// Recognizes An Image From Its First Bytes (8 Are Enough For Every Supported Format)
+int vglDetectFormat(const unsigned char * sig, size_t len) {
+    static const unsigned char png_sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    if(len >= 8 && memcmp(sig, png_sig, 8) == 0)
+        return VGL_FORMAT_PNG;
+    if(len >= 3 && sig[0] == 0xFF && sig[1] == 0xD8 && sig[2] == 0xFF)
+        return VGL_FORMAT_JPEG;
+    if(len >= 4 && memcmp(sig, MAGIC_QOIF, 4) == 0)
+        return VGL_FORMAT_QOI;
+    return VGL_FORMAT_UNKNOWN;
+}
+
+int vglDetectFileFormat(char * filename) {
+    unsigned char sig[8];
+    FILE * fp = fopen(filename, "rb");
+    if( !fp )
+        return VGL_FORMAT_UNKNOWN;
+    size_t len = fread(sig, 1, sizeof(sig), fp);
+    fclose(fp);
+    return vglDetectFormat(sig, len);
+}
+
+// Loads Any Supported Image. Free The Result With free(out->mip[0].data) (Or The Format's unload Function).
+int vglLoad(char * filename, vglImageData * out) {
+    switch (vglDetectFileFormat(filename)) {
+        case VGL_FORMAT_PNG:
+            return loadpng(out, filename);
+        case VGL_FORMAT_JPEG:
+            return loadjpeg(out, filename);
+        case VGL_FORMAT_QOI:
+            return loadqoi(out, filename);
+        default:
+            return UNKNOWN_IMAGE_FORMAT_ERROR;
+    }
+}
+
+// Loads Any Supported Image From The Memory Block [data, data + size). The Block Can Be Released Afterwards.
+int vglLoadMemory(const void * data, size_t size, vglImageData * out) {
+    switch (vglDetectFormat((const unsigned char *) data, size)) {
+        case VGL_FORMAT_PNG:
+            return loadpng_mem(out, data, size);
+        case VGL_FORMAT_JPEG:
+            return loadjpeg_mem(out, data, size);
+        case VGL_FORMAT_QOI:
+            return loadqoi_mem(out, data, size);
+        default:
+            return UNKNOWN_IMAGE_FORMAT_ERROR;
+    }
+}
+
+// Loads The [x, x + width) * [y, y + height) Region Of An Image Without Decoding (Or Storing) The Whole Image.
+// The Region Must Lie Inside The Image. Free The Result With The Format's unload Function (Or free(out->mip[0].data)).
+int vglLoadRegion(char * filename, GLsizei x, GLsizei y, GLsizei width, GLsizei height, vglImageData * out) {
+    switch (vglDetectFileFormat(filename)) {
+        case VGL_FORMAT_PNG:
+            return loadpng_region(out, filename, x, y, width, height);
+        case VGL_FORMAT_JPEG:
+            return loadjpeg_region(out, filename, x, y, width, height);
+        case VGL_FORMAT_QOI:
+            return loadqoi_region(out, filename, x, y, width, height);
+        default:
+            return UNKNOWN_IMAGE_FORMAT_ERROR;
+    }
+}
+
+// Loads An Image Shrunk By The Smallest Integer Factor That Fits It In max_width * max_height (Thumbnails, Low Mips).
+// The Full-Size Image Is Never Stored: JPEGs Are Scaled In The IDCT, PNG And QOI Rows Are Averaged As They Are Decoded.
+// Free The Result With free(out->mip[0].data).
+int vglLoadScaled(char * filename, GLsizei max_width, GLsizei max_height, vglImageData * out) {
+    switch (vglDetectFileFormat(filename)) {
+        case VGL_FORMAT_PNG:
+            return loadpng_scaled(out, filename, max_width, max_height);
+        case VGL_FORMAT_JPEG:
+            return loadjpeg_scaled(out, filename, max_width, max_height);
+        case VGL_FORMAT_QOI:
+            return loadqoi_scaled(out, filename, max_width, max_height);
+        default:
+            return UNKNOWN_IMAGE_FORMAT_ERROR;
+    }
+}
+
+// Streams Any Supported Image Row By Row Through `callback`. `info` Receives The Image Info But No Data.
+int vglLoadRows(char * filename, vglImageData * info, vglRowCallback callback, void * user) {
+    switch (vglDetectFileFormat(filename)) {
+        case VGL_FORMAT_PNG:
+            return loadpng_rows(info, filename, callback, user);
+        case VGL_FORMAT_JPEG:
+            return loadjpeg_rows(info, filename, callback, user);
+        case VGL_FORMAT_QOI:
+            return loadqoi_rows(info, filename, callback, user);
+        default:
+            return UNKNOWN_IMAGE_FORMAT_ERROR;
+    }
+}
+
+// Loads An Image Progressively (Adam7 Passes For Interlaced PNGs, Scans For Progressive JPEGs), Calling `callback`
+// Every Time `image` Has Been Refined. Other Files Are Delivered In One Final Pass. Free The Result With free(image->mip[0].data).
+int vglLoadProgressive(char * filename, vglImageData * image, vglPassCallback callback, void * user) {
+    int res;
+    switch (vglDetectFileFormat(filename)) {
+        case VGL_FORMAT_PNG:
+            return loadpng_progressive(image, filename, callback, user);
+        case VGL_FORMAT_JPEG:
+            return loadjpeg_progressive(image, filename, callback, user);
+        case VGL_FORMAT_QOI:
+            if((res = loadqoi(image, filename)) || !callback)
+                return res;
+            if((res = callback(user, image, 0, 1)) && res != VGL_ROW_STOP) {
+                unloadqoi(image);
+                image->mip[0].data = NULL;
+                return res;
+            }
+            return 0;
+        default:
+            return UNKNOWN_IMAGE_FORMAT_ERROR;
+    }
+}
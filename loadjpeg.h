@@ -1,95 +1,674 @@
+// Image Types Lib (First: It Sets Up The Feature-Test Macros Before Any System Header)
+# ifndef  _LITYPES
+    # include "image_types.h"
+# endif
+
 // Standard Libs
 # include <stdio.h>
 # include <stdlib.h>
+# include <string.h>
+# include <stdint.h>
+# include <setjmp.h>
 
-// JPEG lib 
+// JPEG lib
 # include "jpeglib.h"
 
-// Image Types Lib 
-# ifndef  _LITYPES
-    # include "image_types.h"
+# ifndef _LIPARALLEL
+    # include "parallel.h"
 # endif
 
+# define _LIJPEG 1
+
 # define IMAGE_DOESNT_EXIST_ERROR 19
+# define JPEG_READ_ERROR 0x20
+# define JPEG_OUT_OF_MEM_ERROR 0x21
+# define JPEG_NO_RESTARTS 0x22 // The File Can't Be Decoded In Parallel (Not An Error, We Decode It Sequentially Instead)
+
+// Markers (jpeglib.h Only Has A Few Of Them)
+# define READJPEG_SOI 0xD8
+# define READJPEG_EOI 0xD9
+# define READJPEG_SOF0 0xC0 // Baseline
+# define READJPEG_SOF1 0xC1 // Extended Sequential
+# define READJPEG_DHT 0xC4
+# define READJPEG_SOS 0xDA
+# define READJPEG_DRI 0xDD
+# define READJPEG_RST0 0xD0
+
+// libjpeg Calls exit() On Errors By Default. We Jump Back Into The Loader Instead (The Same Way libpng Does It).
+struct readjpeg_error_mgr {
+    struct jpeg_error_mgr pub;
+    jmp_buf setjmp_buffer;
+};
 
-static int loadjpeg_file(vglImageData *image, FILE *infile);
+// State Of A Parallel Decode. The Scan Is Cut Into Bands At Restart Markers That Fall On MCU Row Boundaries.
+// Every Band Is Decoded As A JPEG Of Its Own: The Original Header With A Smaller Height, Then The Band's Entropy Data.
+struct jpeg_restart_info {
+    const unsigned char * data;
+    size_t size;
+    size_t header_len; // Everything Up To The End Of The SOS Segment
+    size_t sof_height; // Offset Of The Height In The SOF Segment
+    uint32_t width, height, mcu_height, mcu_rows;
+    size_t * segment; // Offset Where Each Restart Interval Starts, Plus The End Of The Scan
+    size_t segments;
+    uint32_t * row; // MCU Row And Segment Of Every Row Boundary That Is Also A Restart Boundary
+    size_t * row_segment;
+    size_t rows;
+    size_t * band; // Bands Start On Row Boundaries band[i], The Last One Ends At row[rows - 1] (The Image Height)
+    size_t bands;
+    size_t rowbytes;
+    unsigned char * out;
+};
+
+static int loadjpeg_file(vglImageData *image, FILE *infile, const void *data, size_t size);
 int loadjpeg(vglImageData *image, char *filename);
+int loadjpeg_mem(vglImageData *image, const void *data, size_t size);
+int unloadjpeg(vglImageData *image);
+int loadjpeg_region(vglImageData *image, char *filename, GLsizei x, GLsizei y, GLsizei width, GLsizei height);
+int loadjpeg_rows(vglImageData *image, char *filename, vglRowCallback callback, void * user);
+int loadjpeg_scaled(vglImageData *image, char *filename, GLsizei max_width, GLsizei max_height);
+static int readjpeg_rows(vglImageData *image, char *filename, int denom, vglRowCallback callback, void * user);
+int loadjpeg_progressive(vglImageData *image, char *filename, vglPassCallback callback, void * user);
+static void readjpeg_error_exit(j_common_ptr cinfo);
+static void readjpeg_start(vglImageData *image, j_decompress_ptr cinfo);
+static void readjpeg_describe(vglImageData *image, j_decompress_ptr cinfo);
+static int readjpeg_parallel(vglImageData *image, const unsigned char *data, size_t size);
+static int readjpeg_restart_scan(struct jpeg_restart_info *info);
+static int readjpeg_restart_band(void * user, size_t band);
+static void readjpeg_silent(j_common_ptr cinfo);
 
 
+// The File Is Read Into Memory First, So Files With Restart Markers Can Be Decoded On Every Core
 int loadjpeg(vglImageData * image, char * filename) {
     FILE * infile;
-    if((infile = fopen(filename, "wb")) != NULL && !loadjpeg_file(image, infile)) {
+    if((infile = fopen(filename, "rb")) == NULL)
+        return IMAGE_DOESNT_EXIST_ERROR;
+
+    unsigned char * data = NULL;
+    long size = -1;
+    if(fseek(infile, 0, SEEK_END) == 0 && (size = ftell(infile)) > 0 && fseek(infile, 0, SEEK_SET) == 0 &&
+       (data = (unsigned char *) malloc((size_t) size)) != NULL && fread(data, 1, (size_t) size, infile) != (size_t) size) {
+        free(data);
+        data = NULL;
+    }
+    if( !data )
+        fseek(infile, 0, SEEK_SET);
+
+    int res = data ? loadjpeg_file(image, NULL, data, (size_t) size) : loadjpeg_file(image, infile, NULL, 0);
+    free(data);
+    fclose(infile);
+    return res;
+}
+
+// Load A Jpeg Image From Memory
+int loadjpeg_mem(vglImageData * image, const void * data, size_t size) {
+    if( !data )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    return loadjpeg_file(image, NULL, data, size);
+}
+
+// Load A Jpeg Image From A File (Or From [data, data + size) When `infile` Is NULL)
+// Baseline Images In Memory With Restart Markers Are Decoded In Parallel, Anything Else (Or Anything Odd About Them) Sequentially.
+static int loadjpeg_file(vglImageData * image, FILE * infile, const void * data, size_t size) {
+    // + Initializing The Structs
+    if( !image )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    if( !infile && readjpeg_parallel(image, (const unsigned char *) data, size) == 0 )
+        return 0;
+    struct jpeg_decompress_struct cinfo;
+    struct readjpeg_error_mgr jerr;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = readjpeg_error_exit;
+    image->mip[0].data = NULL;
+    if( setjmp(jerr.setjmp_buffer) ) {
+        jpeg_destroy_decompress(&cinfo);
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+        return JPEG_READ_ERROR;
+    }
+    jpeg_create_decompress(&cinfo);
+
+    if(infile)
+        jpeg_stdio_src(&cinfo, infile);
+    else
+        jpeg_mem_src(&cinfo, (const unsigned char *) data, (unsigned long) size);
+    jpeg_read_header(&cinfo, TRUE);
+    readjpeg_start(image, &cinfo);
+
+    // Initialize Mip Data
+    size_t rowbytes = (size_t) cinfo.output_width * cinfo.output_components;
+    if((image->mip[0].data = malloc(rowbytes * cinfo.output_height)) == NULL) {
+        jpeg_destroy_decompress(&cinfo);
+        return JPEG_OUT_OF_MEM_ERROR;
+    }
+
+    // Read Data One Scanline At A Time Straight Into The Mip
+    while(cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row_pointer = (JSAMPROW) image->mip[0].data + cinfo.output_scanline * rowbytes;
+        jpeg_read_scanlines(&cinfo, &row_pointer, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+
+    // Dispose Of The JPEG read struct
+    jpeg_destroy_decompress(&cinfo);
+    return 0;
+}
+
+// Streams A JPEG File Row By Row Through `callback` Instead Of Storing It. `image` Receives The Image Info But No Data.
+int loadjpeg_rows(vglImageData * image, char * filename, vglRowCallback callback, void * user) {
+    return readjpeg_rows(image, filename, 1, callback, user);
+}
+
+// Loads A JPEG File Downsampled To Fit In max_width * max_height. The IDCT Produces 1/2, 1/4 Or 1/8 Size Output Itself
+// (libjpeg's DCT Scaling), Whatever Is Left Of The Factor Is Box-Downsampled Row By Row (See vglScaleRow).
+// The Size Matches The Other Loaders: ceil(width / factor) * ceil(height / factor).
+int loadjpeg_scaled(vglImageData * image, char * filename, GLsizei max_width, GLsizei max_height) {
+    if( !image )
+        return IMAGE_DOESNT_EXIST_ERROR;
+
+    // The Header Says How Much To Scale By
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    int res = readjpeg_rows(&info, filename, 1, NULL, NULL);
+    if(res)
+        return res;
+    GLsizei factor = vglScaleFactor(info.mip[0].width, info.mip[0].height, max_width, max_height);
+    int denom = factor % 8 == 0 ? 8 : factor % 4 == 0 ? 4 : factor % 2 == 0 ? 2 : 1;
+
+    // ceil(ceil(width / denom) / (factor / denom)) Is ceil(width / factor), So vglScaleRow Picks factor / denom Itself
+    struct vgl_scale scale = { max_width, max_height, 1, NULL, image };
+    image->mip[0].data = NULL;
+    res = readjpeg_rows(&info, filename, denom, vglScaleRow, &scale);
+    free(scale.sums);
+    if(res && image->mip[0].data) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    return res;
+}
+
+// Streams The Rows Of A JPEG Scaled Down By 1 / `denom` In The IDCT. Without A Callback Only The Size Is Read.
+static int readjpeg_rows(vglImageData * image, char * filename, int denom, vglRowCallback callback, void * user) {
+    if( !image )
+        return IMAGE_DOESNT_EXIST_ERROR;
+
+    FILE * infile;
+    if((infile = fopen(filename, "rb")) == NULL)
+        return IMAGE_DOESNT_EXIST_ERROR;
+
+    struct jpeg_decompress_struct cinfo;
+    struct readjpeg_error_mgr jerr;
+    JSAMPROW volatile scanline = NULL;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = readjpeg_error_exit;
+    if( setjmp(jerr.setjmp_buffer) ) {
+        jpeg_destroy_decompress(&cinfo);
+        fclose(infile);
+        free(scanline);
+        return JPEG_READ_ERROR;
+    }
+    jpeg_create_decompress(&cinfo);
+
+    jpeg_stdio_src(&cinfo, infile);
+    jpeg_read_header(&cinfo, TRUE);
+    if( !callback ) {
+        image->mip[0].width = cinfo.image_width;
+        image->mip[0].height = cinfo.image_height;
+        jpeg_destroy_decompress(&cinfo);
         fclose(infile);
         return 0;
     }
-    else 
-        return -1;
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = denom;
+    readjpeg_start(image, &cinfo);
+
+    int res = 0;
+    scanline = (JSAMPROW) malloc((size_t) cinfo.output_width * cinfo.output_components);
+    if(scanline == NULL)
+        res = JPEG_OUT_OF_MEM_ERROR;
+
+    while(!res && cinfo.output_scanline < cinfo.output_height) {
+        GLsizei row = cinfo.output_scanline;
+        JSAMPROW row_pointer = scanline;
+        jpeg_read_scanlines(&cinfo, &row_pointer, 1);
+        res = callback(user, image, row, scanline);
+    }
+    if(res == VGL_ROW_STOP)
+        res = 0;
+
+    jpeg_abort_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(infile);
+    free(scanline);
+    return res;
+}
+
+// Loads Only The [x, x + width) * [y, y + height) Region Of A JPEG File Into `image`.
+// Rows Above The Region Are Skipped Without Running The IDCT (jpeg_skip_scanlines), Rows Below It Are Never Read,
+// And Only The iMCU Columns Covering The Region Are Decoded (jpeg_crop_scanline).
+int loadjpeg_region(vglImageData * image, char * filename, GLsizei x, GLsizei y, GLsizei width, GLsizei height) {
+    if( !image )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    if( !vgl_region_valid(x, y, width, height) )
+        return REGION_OUT_OF_BOUNDS_ERROR;
+
+    FILE * infile;
+    if((infile = fopen(filename, "rb")) == NULL)
+        return IMAGE_DOESNT_EXIST_ERROR;
+
+    struct jpeg_decompress_struct cinfo;
+    struct readjpeg_error_mgr jerr;
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    struct vgl_region region = { x, y, width, height, 0, image };
+    JSAMPROW volatile scanline = NULL;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = readjpeg_error_exit;
+    image->mip[0].data = NULL;
+    if( setjmp(jerr.setjmp_buffer) ) {
+        jpeg_destroy_decompress(&cinfo);
+        fclose(infile);
+        free(scanline);
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+        return JPEG_READ_ERROR;
+    }
+    jpeg_create_decompress(&cinfo);
+
+    jpeg_stdio_src(&cinfo, infile);
+    jpeg_read_header(&cinfo, TRUE);
+    readjpeg_start(&info, &cinfo);
+
+    int res = 0;
+    if(width > info.mip[0].width - x || height > info.mip[0].height - y)
+        res = REGION_OUT_OF_BOUNDS_ERROR;
+
+    // jpeg_crop_scanline() Widens The Window To iMCU Boundaries. `row_x` Tells vglRegionRow Where Our Rows Start.
+    JDIMENSION crop_x = x, crop_width = width;
+    if( !res ) {
+        jpeg_crop_scanline(&cinfo, &crop_x, &crop_width);
+        region.row_x = crop_x;
+        scanline = (JSAMPROW) malloc((size_t) cinfo.output_width * cinfo.output_components);
+        if(scanline == NULL)
+            res = JPEG_OUT_OF_MEM_ERROR;
+    }
+
+    if( !res ) {
+        jpeg_skip_scanlines(&cinfo, y);
+        while(!res && cinfo.output_scanline < cinfo.output_height) {
+            GLsizei row = cinfo.output_scanline;
+            JSAMPROW row_pointer = scanline;
+            jpeg_read_scanlines(&cinfo, &row_pointer, 1);
+            res = vglRegionRow(&region, &info, row, scanline);
+        }
+        if(res == VGL_ROW_STOP)
+            res = 0;
+    }
+
+    // We Leave The Rest Of The File Undecoded
+    jpeg_abort_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(infile);
+    free(scanline);
+    if(res) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    return res;
 }
 
-// Load A Jpeg Image From A File 
-static int loadjpeg_file(vglImageData * image, FILE * infile) {
-    // + Initializing The Structs 
+// Loads A JPEG File One Scan At A Time (libjpeg's Buffered-Image Mode). After Every Scan `image` Holds The Whole Picture
+// At The Quality Decoded So Far And `callback` Is Told So. Baseline Files Only Have One (Final) Pass.
+// Free The Result With free(image->mip[0].data).
+int loadjpeg_progressive(vglImageData * image, char * filename, vglPassCallback callback, void * user) {
     if( !image )
         return IMAGE_DOESNT_EXIST_ERROR;
-    // + Checking For The 8 Byte PNG Signal 
+
+    FILE * infile;
+    if((infile = fopen(filename, "rb")) == NULL)
+        return IMAGE_DOESNT_EXIST_ERROR;
+
     struct jpeg_decompress_struct cinfo;
-    struct jpeg_error_mgr jerr;
+    struct readjpeg_error_mgr jerr;
 
-    cinfo.err = jpeg_std_error(&jerr);
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = readjpeg_error_exit;
+    image->mip[0].data = NULL;
+    if( setjmp(jerr.setjmp_buffer) ) {
+        jpeg_destroy_decompress(&cinfo);
+        fclose(infile);
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+        return JPEG_READ_ERROR;
+    }
     jpeg_create_decompress(&cinfo);
 
     jpeg_stdio_src(&cinfo, infile);
-    
-    // Filling In Some Default Data 
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.buffered_image = jpeg_has_multiple_scans(&cinfo);
+    readjpeg_start(image, &cinfo);
+
+    size_t rowbytes = (size_t) cinfo.output_width * cinfo.output_components;
+    if((image->mip[0].data = malloc(rowbytes * cinfo.output_height)) == NULL) {
+        jpeg_destroy_decompress(&cinfo);
+        fclose(infile);
+        return JPEG_OUT_OF_MEM_ERROR;
+    }
+
+    int res = 0, pass = 0, final = 0;
+    while( !final && !res ) {
+        // Display The Latest Scan. The Decoder Absorbs The Input It Needs To Complete It.
+        if(cinfo.buffered_image)
+            jpeg_start_output(&cinfo, cinfo.input_scan_number);
+        while(cinfo.output_scanline < cinfo.output_height) {
+            JSAMPROW row_pointer = (JSAMPROW) image->mip[0].data + cinfo.output_scanline * rowbytes;
+            jpeg_read_scanlines(&cinfo, &row_pointer, 1);
+        }
+        if(cinfo.buffered_image) {
+            jpeg_finish_output(&cinfo);
+            final = jpeg_input_complete(&cinfo);
+        } else
+            final = 1;
+
+        if(callback)
+            res = callback(user, image, pass++, final);
+    }
+
+    if(res == VGL_ROW_STOP)
+        res = 0;
+    if(final && !res)
+        jpeg_finish_decompress(&cinfo);
+    else
+        jpeg_abort_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(infile);
+    if(res) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    return res;
+}
+
+// Unloads Image Data
+int unloadjpeg(vglImageData * image) {
+    // Frees The Pixels, The Struct Belongs To The Caller
+    if( image ) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    return 0;
+}
+
+// Starts Decompression And Fills In The Recognized Data. Decompression Parameters Must Be Set Before Calling It.
+static void readjpeg_start(vglImageData * image, j_decompress_ptr cinfo) {
+    jpeg_start_decompress(cinfo);
+    readjpeg_describe(image, cinfo);
+}
+
+// Fills In The Image From The Output Dimensions (Set By jpeg_start_decompress() Or jpeg_calc_output_dimensions())
+static void readjpeg_describe(vglImageData * image, j_decompress_ptr cinfo) {
+    // Filling In Some Default Data
     image->mipmapCount = 1;
     image->target = GL_TEXTURE_2D;
     image->slices = 1;
     image->SliceStride = 0;
 
-    // Filling Int Recognized Data 
-    image->mip[0].width = cinfo.image_width;
-    image->mip[0].height = cinfo.image_height;
+    // Filling Int Recognized Data
+    image->mip[0].width = cinfo->output_width;
+    image->mip[0].height = cinfo->output_height;
     image->mip[0].mipStride = 0;
 
-    // TODO: Provide the user the option if he wants to read 16bit output 
+    // TODO: Provide the user the option if he wants to read 16bit output
     image->type = GL_UNSIGNED_BYTE;
-    if(cinfo.out_color_components == 1) {
-        image->format = GL_R;
+    if(cinfo->output_components == 1) {
+        image->format = GL_RED;
         image->internalFormat = GL_R8;
-    } else if(cinfo.out_color_components == 3) {
+    } else if(cinfo->output_components == 3) {
         image->format = GL_RGB;
-        image->internalFormat = GL_RGB8;
+        image->internalFormat = GL_SRGB8; // JFIF Color Is sRGB
     }
+    image->TextureTotalSize = (GLsizeiptr) cinfo->output_width * cinfo->output_height * cinfo->output_components;
+}
 
-    // Initialize Pointers 
-    JSAMPLE scanline_pointer[cinfo.image_width];
-    JSAMPROW row_pointer[cinfo.image_height];
-    for(size_t i = 0; i < cinfo.image_height; ++i) 
-        row_pointer[i] = scanline_pointer;
+// Message Handler For Decodes Whose Failures Are Handled Quietly
+static void readjpeg_silent(j_common_ptr cinfo) {
+    (void) cinfo;
+}
 
-    JSAMPARRAY arr_pointer = row_pointer;
-    
-    // Read Data One Scanline At A Time 
-    while(cinfo.output_scanline < cinfo.image_height)
-        jpeg_read_scanlines(&cinfo, arr_pointer, 1); // Reading One Line At a time 
+// Error Handler That Jumps Back Into The Loader
+static void readjpeg_error_exit(j_common_ptr cinfo) {
+    struct readjpeg_error_mgr * err = (struct readjpeg_error_mgr *) cinfo->err;
+    (*cinfo->err->output_message)(cinfo);
+    longjmp(err->setjmp_buffer, 1);
+}
 
-    // Initialize Mip Data && Fill It 
-    image->mip[0].data = malloc(cinfo.image_height * cinfo.image_width * cinfo.out_color_components + 1);
-    memcpy(image->mip[0].data, arr_pointer, cinfo.image_height * cinfo.image_width * cinfo.out_color_components);
-    jpeg_finish_decompress(&cinfo);
+static uint32_t readjpeg_u16(const unsigned char * p) {
+    return (uint32_t) p[0] << 8 | p[1];
+}
 
-    // Dispose Of The JPEG read struct 
-    jpeg_destroy_decompress(&cinfo);
+// Decodes A Baseline JPEG With Restart Markers, One Band Of MCU Rows Per Job, Straight Into The Output Buffer.
+// Returns JPEG_NO_RESTARTS (Leaving Nothing Allocated) When The File Needs The Sequential Path: No Restart Markers
+// On Row Boundaries, Progressive Or Arithmetic Coding, More Than One Scan, Or Color Spaces We Don't Load.
+static int readjpeg_parallel(vglImageData * image, const unsigned char * data, size_t size) {
+    if(vglThreadCount() < 2)
+        return JPEG_NO_RESTARTS;
+
+    struct jpeg_restart_info info;
+    memset(&info, 0, sizeof(info));
+    info.data = data;
+    info.size = size;
+    int res = readjpeg_restart_scan(&info);
+
+    // Let libjpeg Read The Whole Header Too, So The Image Is Described Exactly Like The Sequential Path Does It
+    struct jpeg_decompress_struct cinfo;
+    struct readjpeg_error_mgr jerr;
+    if( !res ) {
+        cinfo.err = jpeg_std_error(&jerr.pub);
+        jerr.pub.error_exit = readjpeg_error_exit;
+        jerr.pub.output_message = readjpeg_silent; // The Sequential Fallback Reports Any Real Problem
+        if( setjmp(jerr.setjmp_buffer) ) {
+            jpeg_destroy_decompress(&cinfo);
+            res = JPEG_NO_RESTARTS;
+        } else {
+            jpeg_create_decompress(&cinfo);
+            jpeg_mem_src(&cinfo, data, (unsigned long) size);
+            jpeg_read_header(&cinfo, TRUE);
+            jpeg_calc_output_dimensions(&cinfo); // No Need To Start Decompressing For The Output Size
+            readjpeg_describe(image, &cinfo);
+            if(cinfo.output_width != info.width || cinfo.output_height != info.height || (cinfo.output_components != 1 && cinfo.output_components != 3))
+                res = JPEG_NO_RESTARTS;
+            info.rowbytes = (size_t) cinfo.output_width * cinfo.output_components;
+            jpeg_destroy_decompress(&cinfo);
+        }
+    }
+
+    if( !res ) {
+        if((info.out = (unsigned char *) malloc(info.rowbytes * info.height)) == NULL)
+            res = JPEG_NO_RESTARTS;
+        else if((res = vglParallelFor(info.bands, readjpeg_restart_band, &info))) {
+            free(info.out);
+            info.out = NULL;
+        }
+    }
+    free(info.segment);
+    free(info.row);
+    free(info.row_segment);
+    free(info.band);
+    if(res)
+        return JPEG_NO_RESTARTS;
+    image->mip[0].data = info.out;
     return 0;
 }
 
-// Unloads Image Data 
-int unloadjpeg(vglImageData * image) {
-    // Frees The Structs 
-    free(image);
+// Walks The Markers Up To The Scan, Then Finds Every Restart Marker In It And Plans The Bands.
+static int readjpeg_restart_scan(struct jpeg_restart_info * info) {
+    const unsigned char * data = info->data;
+    size_t size = info->size, pos = 2;
+    uint32_t interval = 0, components = 0, max_h = 1, max_v = 1, scan_components = 0;
+    if(size < 4 || data[0] != 0xFF || data[1] != READJPEG_SOI)
+        return JPEG_NO_RESTARTS;
 
-    return 0;
-    
+    while( !info->header_len ) {
+        while(pos < size && data[pos] == 0xFF && pos + 1 < size && data[pos + 1] == 0xFF)
+            ++pos; // Fill Bytes
+        if(pos + 4 > size || data[pos] != 0xFF)
+            return JPEG_NO_RESTARTS;
+        int marker = data[pos + 1];
+        size_t length = readjpeg_u16(data + pos + 2);
+        if(length < 2 || pos + 2 + length > size)
+            return JPEG_NO_RESTARTS;
+        const unsigned char * segment = data + pos + 4;
+
+        if(marker == READJPEG_SOF0 || marker == READJPEG_SOF1) {
+            if(length < 8)
+                return JPEG_NO_RESTARTS;
+            info->sof_height = pos + 5;
+            info->height = readjpeg_u16(segment + 1);
+            info->width = readjpeg_u16(segment + 3);
+            components = segment[5];
+            if(segment[0] != 8 || length != 8 + 3 * components)
+                return JPEG_NO_RESTARTS;
+            for(uint32_t c = 0; c < components; ++c) {
+                uint32_t h = segment[6 + 3 * c + 1] >> 4, v = segment[6 + 3 * c + 1] & 0x0f;
+                max_h = h > max_h ? h : max_h;
+                max_v = v > max_v ? v : max_v;
+            }
+        } else if(marker >= 0xC2 && marker <= 0xCF && marker != READJPEG_DHT)
+            return JPEG_NO_RESTARTS; // Progressive, Lossless Or Arithmetic Coded
+        else if(marker == READJPEG_DRI) {
+            if(length != 4)
+                return JPEG_NO_RESTARTS;
+            interval = readjpeg_u16(segment);
+        } else if(marker == READJPEG_SOS) {
+            scan_components = segment[0];
+            info->header_len = pos + 2 + length;
+        } else if(marker == READJPEG_EOI)
+            return JPEG_NO_RESTARTS;
+        pos += 2 + length;
+    }
+    // One Scan With Every Component (Or A Lone Gray One), And A Known Height (No DNL)
+    if( !info->sof_height || !interval || !info->width || !info->height || scan_components != components || (components != 1 && components != 3))
+        return JPEG_NO_RESTARTS;
+
+    // A Single Component Scan Isn't Interleaved, Its MCU Is One Block Whatever The Sampling Factors Say
+    uint32_t mcu_width = components == 1 ? 8 : 8 * max_h;
+    info->mcu_height = components == 1 ? 8 : 8 * max_v;
+    uint64_t mcus_per_row = (info->width + mcu_width - 1) / mcu_width;
+    info->mcu_rows = (info->height + info->mcu_height - 1) / info->mcu_height;
+    size_t expected = (size_t) ((mcus_per_row * info->mcu_rows + interval - 1) / interval);
+    if((info->segment = (size_t *) malloc((expected + 1) * sizeof(size_t))) == NULL)
+        return JPEG_NO_RESTARTS;
+
+    // Restart Markers Are The Only Markers Inside The Scan, Anything Else Ends It
+    info->segment[0] = info->header_len;
+    info->segments = 1;
+    for(pos = info->header_len;;) {
+        const unsigned char * ff = (const unsigned char *) memchr(data + pos, 0xFF, size - pos);
+        if( !ff || ff + 1 >= data + size )
+            return JPEG_NO_RESTARTS;
+        pos = ff - data;
+        int marker = data[pos + 1];
+        if(marker == 0x00 || marker == 0xFF)
+            pos += marker ? 1 : 2; // Stuffed Byte Or Fill Byte
+        else if(marker >= READJPEG_RST0 && marker <= READJPEG_RST0 + 7) {
+            if(info->segments == expected || marker != READJPEG_RST0 + (int) ((info->segments - 1) & 7))
+                return JPEG_NO_RESTARTS;
+            pos += 2;
+            info->segment[info->segments++] = pos;
+        } else if(marker == READJPEG_EOI && info->segments == expected) {
+            info->segment[info->segments] = pos + 2; // Segments End 2 Bytes Before The Next One Starts
+            break;
+        } else
+            return JPEG_NO_RESTARTS; // Another Scan, A DNL Or A Damaged Stream
+    }
+
+    // Row Boundaries That Are Also Restart Boundaries, Then The End Of The Image
+    info->row = (uint32_t *) malloc((info->segments + 1) * sizeof(uint32_t));
+    info->row_segment = (size_t *) malloc((info->segments + 1) * sizeof(size_t));
+    if( !info->row || !info->row_segment )
+        return JPEG_NO_RESTARTS;
+    for(size_t k = 0; k < info->segments; ++k)
+        if(((uint64_t) k * interval) % mcus_per_row == 0) {
+            info->row[info->rows] = (uint32_t) ((uint64_t) k * interval / mcus_per_row);
+            info->row_segment[info->rows++] = k;
+        }
+    info->row[info->rows] = info->mcu_rows;
+    info->row_segment[info->rows++] = info->segments;
+
+    // About One Band Per Thread, Cut At The First Boundary Past Each Share
+    size_t threads = (size_t) vglThreadCount(), b = 0;
+    if((info->band = (size_t *) malloc(threads * sizeof(size_t))) == NULL)
+        return JPEG_NO_RESTARTS;
+    for(size_t t = 0; t < threads; ++t) {
+        uint64_t target = (uint64_t) info->mcu_rows * t / threads;
+        while(b + 1 < info->rows && info->row[b] < target)
+            ++b;
+        if(b + 1 < info->rows && (info->bands == 0 || info->band[info->bands - 1] != b))
+            info->band[info->bands++] = b;
+    }
+    return info->bands < 2 ? JPEG_NO_RESTARTS : 0;
 }
 
+// Job: Decodes One Band. It Starts A Row Boundary Early And Ends One Late When It Can, So The Chroma Upsampling
+// At The Band's Edges Sees The Same Neighbours As A Sequential Decode. Those Extra Rows Are Thrown Away.
+static int readjpeg_restart_band(void * user, size_t band) {
+    struct jpeg_restart_info * info = (struct jpeg_restart_info *) user;
+    size_t first = info->band[band], last = band + 1 < info->bands ? info->band[band + 1] : info->rows - 1;
+    size_t from = first > 0 ? first - 1 : first, to = last + 1 < info->rows ? last + 1 : last;
+    size_t seg_from = info->row_segment[from], seg_to = info->row_segment[to];
+
+    // Header With The Band's Height, Entropy Data With Its Restart Markers Renumbered From RST0, EOI
+    uint32_t top = info->row[from] * info->mcu_height;
+    uint32_t bottom = to == info->rows - 1 ? info->height : info->row[to] * info->mcu_height;
+    size_t start = info->segment[seg_from], end = info->segment[seg_to] - 2;
+    size_t length = info->header_len + (end - start) + 2;
+    unsigned char * stream = (unsigned char *) malloc(length);
+    if( !stream )
+        return JPEG_OUT_OF_MEM_ERROR;
+    memcpy(stream, info->data, info->header_len);
+    stream[info->sof_height] = (unsigned char) ((bottom - top) >> 8);
+    stream[info->sof_height + 1] = (unsigned char) (bottom - top);
+    memcpy(stream + info->header_len, info->data + start, end - start);
+    for(size_t k = seg_from + 1; k < seg_to; ++k)
+        stream[info->header_len + (info->segment[k] - 1 - start)] = (unsigned char) (READJPEG_RST0 + ((k - seg_from - 1) & 7));
+    stream[length - 2] = 0xFF;
+    stream[length - 1] = READJPEG_EOI;
 
+    struct jpeg_decompress_struct cinfo;
+    struct readjpeg_error_mgr jerr;
+    unsigned char * volatile scratch = NULL;
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = readjpeg_error_exit;
+    jerr.pub.output_message = readjpeg_silent; // The Sequential Fallback Reports Any Real Problem
+    if( setjmp(jerr.setjmp_buffer) ) {
+        jpeg_destroy_decompress(&cinfo);
+        free(stream);
+        free(scratch);
+        return JPEG_READ_ERROR;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, stream, (unsigned long) length);
+    jpeg_read_header(&cinfo, TRUE);
+    jpeg_start_decompress(&cinfo);
+
+    int res = 0;
+    uint32_t y = top, y_first = info->row[first] * info->mcu_height;
+    uint32_t y_last = band + 1 < info->bands ? info->row[last] * info->mcu_height : info->height;
+    if((size_t) cinfo.output_width * cinfo.output_components != info->rowbytes || cinfo.output_height != bottom - top)
+        res = JPEG_READ_ERROR;
+    else if(y < y_first && (scratch = (unsigned char *) malloc(info->rowbytes)) == NULL)
+        res = JPEG_OUT_OF_MEM_ERROR;
+    for(; !res && y < y_last; ++y) {
+        JSAMPROW row_pointer = y < y_first ? scratch : info->out + (size_t) y * info->rowbytes;
+        if(jpeg_read_scanlines(&cinfo, &row_pointer, 1) != 1)
+            res = JPEG_READ_ERROR;
+    }
+
+    jpeg_abort_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    free(stream);
+    free(scratch);
+    return res;
+}
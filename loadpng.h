@@ -1,12 +1,19 @@
+# ifndef  _LITYPES 
+    # include "image_types.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
 # include <stdio.h>
 # include <stdlib.h>
 # include <stdint.h>
+# include <string.h>
 # include "png.h" // This Also Includes The <zlib.h> function
+# include <zlib.h>
 
-# ifndef  _LITYPES 
-    # include "image_types.h"
+# ifndef _LIPARALLEL
+    # include "parallel.h"
 # endif
 
+# define _LIPNG 1
+
 // Definitions
 # define DEFAULT_BACKGROUND_COLOR 0xFFFF
 # define BAD_SIG_ERROR 1
@@ -15,18 +22,78 @@
 # define PNG_ILLEGAL_BIT_DEPTH_ERROR 9
 # define PNG_ILLEGAL_COLOR_TYPE_ERROR 10
 # define IMAGE_DOESNT_EXIST_ERROR 19
+# define PNG_NO_RESTARTS 0x30 // The File Can't Be Decoded In Parallel (Not An Error, We Use libpng Instead)
+# define PNG_SRGB_GAMMA 0.45455 // gAMA Of sRGB Files
+# ifndef PNG_USER_WIDTH_MAX
+    # define PNG_USER_WIDTH_MAX 1000000 // libpng's Defaults, For Builds Without User Limits
+# endif
+# ifndef PNG_USER_HEIGHT_MAX
+    # define PNG_USER_HEIGHT_MAX 1000000
+# endif
+
+// Restart Chunk. Lets Row Bands Of A PNG Be Inflated And Unfiltered Independently (And So In Parallel).
+// It's Ancillary, Private And Unsafe-To-Copy (The Offsets Only Hold For The IDAT Stream They Were Written With), And Comes Before The First IDAT.
+// Big-Endian Payload:
+//      uint32 count                                Number Of Segments
+//      count * { uint32 first_row, uint32 offset } Segment Start Row And Its Offset Into The Concatenated IDAT Data
+// The Encoder Did A Z_FULL_FLUSH Right Before Every Segment, So A Raw Inflate Can Start At `offset`,
+// And The First Row Of Every Segment Uses Filter None Or Sub So It Doesn't Depend On The Previous Segment.
+# define PNG_RESTART_CHUNK "vgRS"
+# define PNG_MAX_RESTARTS 0x10000
+
+// State Of A Parallel Decode
+struct png_restart_info {
+    uint32_t width, height;
+    int bit_depth, color_type, channels;
+    size_t rowbytes; // Unfiltered Row Size
+    int bpp; // Bytes Per Complete Pixel (What The Filters Use)
+    int srgb; // Has An sRGB Chunk, Or A gAMA Close To sRGB's
+    uint32_t count;
+    uint32_t * first_row;
+    uint32_t * offset;
+    png_bytep stream; // Concatenated IDAT Data
+    size_t stream_len;
+    png_bytep out;
+};
+
+// Where The Whole-Image Paths Read From : A File, Or A Block Of Memory When `fp` Is NULL
+struct png_source {
+    FILE * fp;
+    png_const_bytep data;
+    size_t size;
+    size_t pos;
+};
 
 
 // Functions 
 int loadpng(vglImageData *image, char *filename);
-static int loadpng_file(vglImageData *image, FILE *file);
+int loadpng_mem(vglImageData *image, const void *data, size_t size);
+static int readpng_load(vglImageData *image, struct png_source *src);
+static int loadpng_file(vglImageData *image, struct png_source *src);
 int unloadpng(vglImageData * image);
-static int readpng_init(vglImageData *image, FILE *fp, png_structp , png_infop, int * color_type, int * bit_depth);
+static int readpng_init(vglImageData *image, png_structp , png_infop, int * color_type, int * bit_depth);
 static int readpng_bgcolor(png_color_16p color, png_structp png_ptr, png_infop info_ptr);
 static int readpng_image(vglImageData *image, png_structp png_ptr, png_infop info_ptr, const int color_type, const int bit_depth, png_color_16p background_color, int is_default_bg); 
 static int readpng_cleanup(png_structp png_ptr, png_infop info_ptr);
-
-static int log_error( char * message) {
+static int readpng_transforms(vglImageData *image, png_structp png_ptr, png_infop info_ptr, const int color_type, const int bit_depth, png_color_16p background_color, int is_default_bg);
+static int readpng_rows(vglImageData *image, FILE *fp, GLsizei first_row, GLsizei last_row, vglRowCallback callback, void * user);
+int loadpng_region(vglImageData *image, char *filename, GLsizei x, GLsizei y, GLsizei width, GLsizei height);
+int loadpng_scaled(vglImageData *image, char *filename, GLsizei max_width, GLsizei max_height);
+int loadpng_rows(vglImageData *image, char *filename, vglRowCallback callback, void * user);
+int loadpng_progressive(vglImageData *image, char *filename, vglPassCallback callback, void * user);
+static int readpng_create(FILE *fp, png_structp *png_ptr, png_infop *info_ptr);
+static int readpng_setup(vglImageData *image, FILE *fp, png_structp png_ptr, png_infop info_ptr);
+static int readpng_parallel(vglImageData *image, struct png_source *src);
+static int readpng_restart_scan(struct png_source *src, struct png_restart_info *info);
+static size_t readpng_src_read(struct png_source *src, void *buffer, size_t size);
+static int readpng_src_seek(struct png_source *src, long offset, int whence);
+static long readpng_src_tell(struct png_source *src);
+static void readpng_src_callback(png_structp png_ptr, png_bytep buffer, size_t size);
+static int readpng_restart_segment(void * user, size_t segment);
+static void readpng_unfilter(int filter, png_bytep row, png_const_bytep src, png_const_bytep prior, size_t rowbytes, int bpp);
+static int readpng_is_srgb(int has_srgb, int has_gamma, double gamma);
+
+static int log_error(const char * message) {
     FILE * fp = stderr;
     fprintf(fp, "Compiled with libpng version %s; using libpng %s;\n", PNG_LIBPNG_VER_STRING, png_libpng_ver);
     fputs(message, fp);
@@ -36,18 +103,130 @@ static int log_error( char * message) {
 
 int loadpng(vglImageData * image, char * filename) {
     FILE * fp = fopen(filename, "rb");
-    return loadpng_file(image, fp);
+    if( !fp )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    struct png_source src = { fp, NULL, 0, 0 };
+    int res = readpng_load(image, &src);
     fclose(fp);
+    return res;
+}
+
+// Loads A PNG From Memory. Both Decoding Paths Read The Block In Place.
+int loadpng_mem(vglImageData * image, const void * data, size_t size) {
+    if( !data || !size )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    struct png_source src = { NULL, (png_const_bytep) data, size, 0 };
+    return readpng_load(image, &src);
+}
+
+// Files With A Restart Chunk Are Decoded On Every Core, Anything Else (Or Anything Odd About Them) Goes Through libpng.
+static int readpng_load(vglImageData * image, struct png_source * src) {
+    int res = readpng_parallel(image, src);
+    if(res) {
+        readpng_src_seek(src, 0, SEEK_SET);
+        res = loadpng_file(image, src);
+    }
+    return res;
+}
+
+static size_t readpng_src_read(struct png_source * src, void * buffer, size_t size) {
+    if(src->fp)
+        return fread(buffer, 1, size, src->fp);
+    if(size > src->size - src->pos)
+        size = src->size - src->pos;
+    memcpy(buffer, src->data + src->pos, size);
+    src->pos += size;
+    return size;
+}
+
+static int readpng_src_seek(struct png_source * src, long offset, int whence) {
+    if(src->fp)
+        return fseek(src->fp, offset, whence);
+    long base = whence == SEEK_SET ? 0 : whence == SEEK_CUR ? (long) src->pos : (long) src->size;
+    if(offset < -base || (size_t) (base + offset) > src->size)
+        return -1;
+    src->pos = (size_t) (base + offset);
+    return 0;
+}
+
+static long readpng_src_tell(struct png_source * src) {
+    return src->fp ? ftell(src->fp) : (long) src->pos;
+}
+
+// libpng Read Function For A png_source
+static void readpng_src_callback(png_structp png_ptr, png_bytep buffer, size_t size) {
+    if(readpng_src_read((struct png_source *) png_get_io_ptr(png_ptr), buffer, size) != size)
+        png_error(png_ptr, "Read Error");
+}
+
+// Streams A PNG File Row By Row Through `callback` Instead Of Storing It. `image` Receives The Image Info But No Data.
+int loadpng_rows(vglImageData * image, char * filename, vglRowCallback callback, void * user) {
+    if( !image )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    FILE * fp = fopen(filename, "rb");
+    if( !fp )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    int res = readpng_rows(image, fp, 0, -1, callback, user);
+    fclose(fp);
+    return res;
+}
+
+// Loads Only The [x, x + width) * [y, y + height) Region Of A PNG File Into `image`.
+// Rows Below The Region Are Never Decoded And Columns Outside It Are Never Stored, So Memory Scales With The Region.
+// (Interlaced Files Still Have To Inflate Every Pass, But Only The Region's Rows Are Buffered.)
+int loadpng_region(vglImageData * image, char * filename, GLsizei x, GLsizei y, GLsizei width, GLsizei height) {
+    if( !image )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    if( !vgl_region_valid(x, y, width, height) )
+        return REGION_OUT_OF_BOUNDS_ERROR;
+
+    FILE * fp = fopen(filename, "rb");
+    if( !fp )
+        return IMAGE_DOESNT_EXIST_ERROR;
+
+    struct vgl_region region = { x, y, width, height, 0, image };
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    image->mip[0].data = NULL;
+    int res = readpng_rows(&info, fp, y, y + height - 1, vglRegionRow, &region);
+    fclose(fp);
+    if(res && image->mip[0].data) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    return res;
+}
+
+// Loads A PNG File Box-Downsampled To Fit In max_width * max_height (See vglScaleRow), A Row At A Time.
+// Only Interlaced Files Need Their Full-Size Rows Buffered, Until The Last Pass.
+int loadpng_scaled(vglImageData * image, char * filename, GLsizei max_width, GLsizei max_height) {
+    if( !image )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    FILE * fp = fopen(filename, "rb");
+    if( !fp )
+        return IMAGE_DOESNT_EXIST_ERROR;
+
+    struct vgl_scale scale = { max_width, max_height, 1, NULL, image };
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    image->mip[0].data = NULL;
+    int res = readpng_rows(&info, fp, 0, -1, vglScaleRow, &scale);
+    fclose(fp);
+    free(scale.sums);
+    if(res && image->mip[0].data) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    return res;
 }
 
-int loadpng_file(vglImageData * image, FILE * fp) {
+static int loadpng_file(vglImageData * image, struct png_source * src) {
     
     if( !image )
         return IMAGE_DOESNT_EXIST_ERROR;
     // + Checking For The 8 Byte PNG Signal 
     unsigned char sig[8];
-    fread(sig, 8, 1, fp);
-    if(!png_check_sig(sig, 8)) {
+    if(readpng_src_read(src, sig, 8) != 8 || !png_check_sig(sig, 8)) {
         log_error("Error: Loading PNG: Bad PNG SIG.\n");
         return BAD_SIG_ERROR;
     }
@@ -85,8 +264,10 @@ int loadpng_file(vglImageData * image, FILE * fp) {
 
     int color_type, bit_depth;
     int res;
-    if((res =readpng_init(image, fp, png_ptr, info_ptr, &color_type, &bit_depth))) {
+    png_set_read_fn(png_ptr, src, readpng_src_callback);
+    if((res =readpng_init(image, png_ptr, info_ptr, &color_type, &bit_depth))) {
         log_error("Error: Loading PNG: Illegal Header Info \n");
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
         return res;
     }
 
@@ -118,12 +299,12 @@ int unloadpng(vglImageData *image) {
 }
 
 // Creates The `png_ptr` and `info_ptr` structs. Also Reads The IHDR chunk in the PNG file.
-static int readpng_init(vglImageData * image, FILE * fp, png_structp png_ptr, png_infop info_ptr, int * ct, int * bd) {
+// The Caller Sets Up Where libpng Reads From (png_init_io() Or png_set_read_fn()).
+static int readpng_init(vglImageData * image, png_structp png_ptr, png_infop info_ptr, int * ct, int * bd) {
 
 
 
     // + Init Reading The PNG
-    png_init_io(png_ptr, fp); // This here Initializes reading the png file and stores the data into png_ptr.
     png_set_sig_bytes(png_ptr, 8); // Lets libpng know we already checked the first 8 bytes of the png stream.
     png_read_info(png_ptr, info_ptr); // Reads up to the first IDAT chunk in the png file. Which includes 
                                       // any IHDR, PLTE chunks alongside iCCP, gAMA, cHRM, sRGB, tRNS, bKGD, tIME ...etc. You get the idea 
@@ -166,7 +347,7 @@ static int readpng_init(vglImageData * image, FILE * fp, png_structp png_ptr, pn
                     default:
                         return PNG_ILLEGAL_BIT_DEPTH_ERROR;
                 }
-                image->TextureTotalSize = width * height * (bit_depth / 8);
+                image->TextureTotalSize = (GLsizeiptr) width * height * (bit_depth / 8);
                 break;
             case 0x2: 
                 image->format = GL_RGB;
@@ -182,7 +363,7 @@ static int readpng_init(vglImageData * image, FILE * fp, png_structp png_ptr, pn
                     default:
                         return PNG_ILLEGAL_BIT_DEPTH_ERROR;
                 }
-                image->TextureTotalSize = width * height * (bit_depth / 8) * 3;
+                image->TextureTotalSize = (GLsizeiptr) width * height * (bit_depth / 8) * 3;
                 break;
             case 4 :
                 image->format = GL_RG;
@@ -198,7 +379,7 @@ static int readpng_init(vglImageData * image, FILE * fp, png_structp png_ptr, pn
                     default:
                         return PNG_ILLEGAL_BIT_DEPTH_ERROR;
                 }
-                image->TextureTotalSize = width * height * (bit_depth / 4);
+                image->TextureTotalSize = (GLsizeiptr) width * height * (bit_depth / 4);
                 break;
             case 6 :
                 image->format = GL_RGBA;
@@ -214,8 +395,8 @@ static int readpng_init(vglImageData * image, FILE * fp, png_structp png_ptr, pn
                     default:
                         return PNG_ILLEGAL_BIT_DEPTH_ERROR;
                 }
+                image->TextureTotalSize = (GLsizeiptr) width * height * (bit_depth / 2);
                 break;
-                image->TextureTotalSize = width * height * (bit_depth / 2);
             default: 
                  return PNG_ILLEGAL_COLOR_TYPE_ERROR;
 
@@ -232,7 +413,9 @@ static int readpng_bgcolor(png_color_16p  background_color, png_structp png_ptr,
     if(!png_get_valid(png_ptr,  info_ptr, PNG_INFO_bKGD))
         return PNG_READ_ERROR;
 
-    png_get_bKGD(png_ptr,info_ptr, &background_color); // reads The bKGD structs and gets us some info 
+    png_color_16p pBackground;
+    png_get_bKGD(png_ptr,info_ptr, &pBackground); // reads The bKGD structs and gets us some info 
+    *background_color = *pBackground;
   
 
     // pBackground is a pointer to a png_color_16 struct which is defined as : 
@@ -262,54 +445,56 @@ static int readpng_image(vglImageData * image, png_structp png_ptr, png_infop in
         return PNG_READ_ERROR;
     }
 
-    // + Gamma correction : 
-    double LUT_exponent = 1.0; // Most PCs forego the LUT exponent which makes it by default 1.0
-    double CRT_exponent = 2.2; // Most Displays nowadays used 2.2 as a default gamma  
-    double default_display_exponent;
-
-    // For Some cases the LUT exponent may differ that's why : 
-    # if defined (NeXT) 
-        LUT_exponent = 1.0 / 2.2;
-        /*
-        if(some_next_function_that_returns_gamma(&next_gamma))
-            LUT_exponent = 1.0 / next_gamma;
-
-        */
-    # elif defined(sgi) 
-        LUT_exponent = 1.0 / 1.7;
-        /* there doesn't seem to be any documented function to get the "gamma" value, so we do it the hard way */
-        FILE * infile = fopen("/etc/config/system.glGammaVal", "r");
-        if(infile) {
-            double sgi_gamma;
-            char fooline[81];
-            fgets(fooline, 80, infile);
-            fooline[80] = '\0';
-            fclose(infile);
-            sgi_gamma = atof(fooline);
-            if(sgi_gamma > 0.0)
-                LUT_exponent = 1.0 / sgi_gamma;
-        }
-    # elif defined (Macintosh)
-        LUT_exponent = 1.8 / 2.61;
-        /* if (some_mac_function_that_returns_gamma(&mac_gamma))
-            LUT_exponent = mac_gamma / 2.61;
-        */
-    # endif
+    readpng_transforms(image, png_ptr, info_ptr, color_type, bit_depth, background_color, is_default_bg);
+
+    // Sizes Are Kept In size_t: A 40K x 40K RGBA Image Is Already Past 4GB. The Row Table Lives On The Heap For The Same Reason.
+    size_t i, rowbytes, height = image->mip[0].height;
+    png_bytep * row_pointers;
+
+    rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    if(height && rowbytes > SIZE_MAX / height) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return OUT_OF_MEM_ERROR;
+    }
+
+    if((image->mip[0].data = malloc(rowbytes * height)) == NULL) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return OUT_OF_MEM_ERROR; 
+    }
+    if((row_pointers = (png_bytep *) malloc(height * sizeof(png_bytep))) == NULL) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return OUT_OF_MEM_ERROR; 
+    }
+
+    image->TextureTotalSize = rowbytes * height;
+    for( i = 0; i < height; ++i) 
+        row_pointers[i] = ((png_bytep) image->mip[0].data) + i * rowbytes; 
+
+    // Redirect Errors From Here On So The Row Table Doesn't Leak
+    if( setjmp(png_jmpbuf(png_ptr)) ) {
+        free(row_pointers);
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return PNG_READ_ERROR;
+    }
 
-    default_display_exponent = LUT_exponent * CRT_exponent;
+    png_read_image(png_ptr, row_pointers);
 
-    double display_component;
-    char * p;
-    if((p = getenv("SCREEN_GAMMA")) != NULL)
-        display_component = atof(p);
-    else 
-        display_component = default_display_exponent;
-    // TODO: Provide the user with an option to alter gamma.
-    double gamma;
-    if(png_get_gAMA(png_ptr, info_ptr, &gamma))
-        png_set_gamma(png_ptr, display_component, gamma); 
+    png_read_end(png_ptr, NULL);
+    free(row_pointers);
 
-    // TODO: Do some color correction I guess.
+    return 0;
+}
+
+// Sets Up The Color Transformations, Then Updates `image` To Describe The Transformed Rows.
+// Pixels Are Never Gamma Corrected: sRGB Images Get An sRGB Internal Format So The GPU Linearizes Them When Sampling.
+static int readpng_transforms(vglImageData * image, png_structp png_ptr, png_infop info_ptr, const int color_type, const int bit_depth, png_color_16p background_color, int is_default_bg) {
+    double gamma = 0.0;
+    int has_gamma = png_get_gAMA(png_ptr, info_ptr, &gamma) != 0;
+    int srgb = readpng_is_srgb(png_get_valid(png_ptr, info_ptr, PNG_INFO_sRGB) != 0, has_gamma, gamma);
 
     // + Reading The Image : 
     // Do Some Color Transformations Here And There ;
@@ -320,34 +505,107 @@ static int readpng_image(vglImageData * image, png_structp png_ptr, png_infop in
     else if(png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
         png_set_tRNS_to_alpha(png_ptr); // Expands transparency inforamtions into an alpha channel 
 
-    uint32_t i, rowbytes;
-    png_bytep row_pointers[image->mip[0].height];
-
-    if(((color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) || (color_type == PNG_COLOR_TYPE_PALETTE)) && !is_default_bg)
-        png_set_background(png_ptr, background_color, PNG_BACKGROUND_GAMMA_FILE, 1, gamma);
-    else 
-        png_set_background(png_ptr, background_color, PNG_BACKGROUND_GAMMA_FILE, 0, gamma);
+    // Only Flatten Against A Background The File Actually Asks For, Otherwise Keep The Alpha Channel.
+    if(!is_default_bg) {
+        if((color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) || (color_type == PNG_COLOR_TYPE_PALETTE))
+            png_set_background(png_ptr, background_color, PNG_BACKGROUND_GAMMA_FILE, 1, 1.0);
+        else 
+            png_set_background(png_ptr, background_color, PNG_BACKGROUND_GAMMA_FILE, 0, 1.0);
+    }
 
+    png_set_interlace_handling(png_ptr); // Lets libpng Combine Adam7 Passes For Us.
     png_read_update_info(png_ptr, info_ptr);  
-    
 
-    rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    // The Transformations May Add Or Remove Channels (tRNS, bKGD) So The Format Comes From The Updated Info.
+    int channels = png_get_channels(png_ptr, info_ptr);
+    int wide = png_get_bit_depth(png_ptr, info_ptr) == 16;
+    image->type = wide ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+    switch (channels) {
+        case 1: image->format = GL_RED; image->internalFormat = wide ? GL_R16 : GL_R8; break;
+        case 2: image->format = GL_RG; image->internalFormat = wide ? GL_RG16 : GL_RG8; break;
+        case 3: image->format = GL_RGB; image->internalFormat = wide ? GL_RGB16 : srgb ? GL_SRGB8 : GL_RGB8; break;
+        case 4: image->format = GL_RGBA; image->internalFormat = wide ? GL_RGBA16 : srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8; break;
+    }
+    image->TextureTotalSize = png_get_rowbytes(png_ptr, info_ptr) * image->mip[0].height;
+
+    return 0;
+}
 
-    if((image->mip[0].data = malloc(rowbytes * image->mip[0].height)) == NULL) {
+// An sRGB Chunk Or A gAMA Of About 1/2.2 Means sRGB Pixels. Other Gammas (And Untagged Files) Keep The Linear Formats,
+// There's No Hardware Decoding For Them, And Their Pixels Are Still Left As They Are.
+static int readpng_is_srgb(int has_srgb, int has_gamma, double gamma) {
+    return has_srgb || (has_gamma && gamma > PNG_SRGB_GAMMA - 0.01 && gamma < PNG_SRGB_GAMMA + 0.01);
+}
+
+// Streams The Rows Of A PNG File Through `callback`, Stopping After `last_row` (A Negative `last_row` Means The Whole Image).
+// Non-Interlaced Files Are Decoded Through A Single Row Buffer. Interlaced Files Need Every Pass, So The Rows In
+// [first_row, last_row] Are Buffered Until The Last Pass And Everything Else Goes Through A Scratch Row.
+static int readpng_rows(vglImageData * image, FILE * fp, GLsizei first_row, GLsizei last_row, vglRowCallback callback, void * user) {
+    png_structp png_ptr;
+    png_infop info_ptr;
+    int res;
+    if((res = readpng_create(fp, &png_ptr, &info_ptr)))
+        return res;
+
+    // These Are Touched After setjmp() So They Have To Survive A longjmp().
+    png_bytep volatile scratch = NULL;
+    png_bytep volatile rows = NULL;
+    if( setjmp(png_jmpbuf(png_ptr)) ) {
+        free(scratch);
+        free(rows);
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-        return OUT_OF_MEM_ERROR; 
+        return PNG_READ_ERROR;
     }
 
-    image->TextureTotalSize = rowbytes * image->mip[0].height;
-    for( i = 0; i < image->mip[0].height; ++i) 
-        row_pointers[i] = ((png_bytep) image->mip[0].data) + i * rowbytes; 
-   
+    if((res = readpng_setup(image, fp, png_ptr, info_ptr))) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return res;
+    }
 
-    png_read_image(png_ptr, row_pointers);
+    GLsizei height = image->mip[0].height;
+    if(last_row < 0)
+        last_row = height - 1;
+    if(first_row < 0 || first_row > last_row || last_row >= height) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return REGION_OUT_OF_BOUNDS_ERROR;
+    }
 
-    png_read_end(png_ptr, NULL);
+    size_t rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    GLsizei y;
+    res = 0;
+    scratch = (png_bytep) malloc(rowbytes);
+    if(scratch == NULL) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return OUT_OF_MEM_ERROR;
+    }
 
-    return 0;
+    if(png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE) {
+        for(y = 0; y <= last_row && !res; ++y) {
+            png_read_row(png_ptr, scratch, NULL);
+            if(y >= first_row)
+                res = callback(user, image, y, scratch);
+        }
+    } else {
+        size_t kept = (size_t) (last_row - first_row + 1);
+        rows = (png_bytep) calloc(kept, rowbytes);
+        if(rows == NULL) {
+            free(scratch);
+            png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+            return OUT_OF_MEM_ERROR;
+        }
+        int pass, passes = png_set_interlace_handling(png_ptr);
+        for(pass = 0; pass < passes; ++pass)
+            for(y = 0; y < height; ++y)
+                png_read_row(png_ptr, (y >= first_row && y <= last_row) ? rows + (y - first_row) * rowbytes : scratch, NULL);
+
+        for(y = first_row; y <= last_row && !res; ++y)
+            res = callback(user, image, y, rows + (y - first_row) * rowbytes);
+    }
+
+    free(scratch);
+    free(rows);
+    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    return res == VGL_ROW_STOP ? 0 : res;
 }
 
 static int readpng_cleanup(png_structp png_ptr, png_infop info_ptr) {
@@ -358,3 +616,359 @@ static int readpng_cleanup(png_structp png_ptr, png_infop info_ptr) {
     }
     return 0;
 }
+
+// Checks The Signature And Creates The `png_ptr` And `info_ptr` Structs.
+static int readpng_create(FILE * fp, png_structp * png_ptr, png_infop * info_ptr) {
+    unsigned char sig[8];
+    if(fread(sig, 1, 8, fp) != 8 || !png_check_sig(sig, 8)) {
+        log_error("Error: Loading PNG: Bad PNG SIG.\n");
+        return BAD_SIG_ERROR;
+    }
+
+    *png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if(!*png_ptr) {
+        log_error("Error: Loading PNG: Out Of Memory. \n");
+        return OUT_OF_MEM_ERROR;
+    }
+    *info_ptr = png_create_info_struct(*png_ptr);
+    if(!*info_ptr) {
+        png_destroy_read_struct(png_ptr, NULL, NULL);
+        log_error("Error: Loading PNG: Out Of Memory. \n");
+        return OUT_OF_MEM_ERROR;
+    }
+    return 0;
+}
+
+// Reads The Header And Background And Sets Up The Transformations. Must Be Called After setjmp().
+static int readpng_setup(vglImageData * image, FILE * fp, png_structp png_ptr, png_infop info_ptr) {
+    int color_type, bit_depth;
+    int res;
+    png_init_io(png_ptr, fp); // This here Initializes reading the png file and stores the data into png_ptr.
+    if((res = readpng_init(image, png_ptr, info_ptr, &color_type, &bit_depth))) {
+        log_error("Error: Loading PNG: Illegal Header Info \n");
+        return res;
+    }
+
+    png_color_16 background_color;
+    int is_def_bg = 0;
+    if((is_def_bg = readpng_bgcolor(&background_color, png_ptr, info_ptr)))
+        background_color.red = background_color.green = background_color.blue = background_color.gray = DEFAULT_BACKGROUND_COLOR; 
+
+    return readpng_transforms(image, png_ptr, info_ptr, color_type, bit_depth, &background_color, is_def_bg);
+}
+
+// Loads A PNG File One Adam7 Pass At A Time. After Every Pass `image` Holds The Whole Picture At The Resolution Decoded So Far
+// (libpng Fills The Missing Pixels With Rectangles) And `callback` Is Told So. The First Pass Carries 1/64 Of The Pixels.
+// Non-Interlaced Files Only Have One (Final) Pass. Free The Result With unloadpng().
+int loadpng_progressive(vglImageData * image, char * filename, vglPassCallback callback, void * user) {
+    if( !image )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    FILE * fp = fopen(filename, "rb");
+    if( !fp )
+        return IMAGE_DOESNT_EXIST_ERROR;
+
+    png_structp png_ptr;
+    png_infop info_ptr;
+    int res;
+    if((res = readpng_create(fp, &png_ptr, &info_ptr))) {
+        fclose(fp);
+        return res;
+    }
+
+    image->mip[0].data = NULL;
+    png_bytep * volatile row_pointers = NULL;
+    if( setjmp(png_jmpbuf(png_ptr)) ) {
+        free(row_pointers);
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        fclose(fp);
+        return PNG_READ_ERROR;
+    }
+
+    if((res = readpng_setup(image, fp, png_ptr, info_ptr))) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        fclose(fp);
+        return res;
+    }
+
+    size_t rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    GLsizei y, height = image->mip[0].height;
+    if(height > 0 && rowbytes <= SIZE_MAX / (size_t) height && (size_t) height <= SIZE_MAX / sizeof(png_bytep)) {
+        image->mip[0].data = malloc(rowbytes * height);
+        row_pointers = (png_bytep *) malloc(height * sizeof(png_bytep));
+    }
+    if(!image->mip[0].data || !row_pointers) {
+        free(row_pointers);
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        fclose(fp);
+        return OUT_OF_MEM_ERROR;
+    }
+    for(y = 0; y < height; ++y)
+        row_pointers[y] = (png_bytep) image->mip[0].data + y * rowbytes;
+
+    int pass, passes = 1;
+    if(png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE)
+        passes = png_set_interlace_handling(png_ptr);
+
+    for(pass = 0; pass < passes && !res; ++pass) {
+        // Passing The Rows As `display_row` Gets Us The "Rectangle" Effect Instead Of Sparse Pixels
+        for(y = 0; y < height; ++y)
+            png_read_row(png_ptr, NULL, row_pointers[y]);
+        if(callback)
+            res = callback(user, image, pass, pass == passes - 1);
+    }
+
+    if(res == VGL_ROW_STOP)
+        res = 0;
+    else if( !res )
+        png_read_end(png_ptr, NULL);
+
+    free(row_pointers);
+    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    fclose(fp);
+    if(res) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    return res;
+}
+
+// Decodes A PNG With A Restart Chunk, One Row Band Per Job, Straight Into The Output Buffer.
+// Returns PNG_NO_RESTARTS (Leaving Nothing Allocated) When The File Needs The libpng Path: No Restart Chunk, Interlacing,
+// Palettes, Sub-Byte Depths, Or Chunks That Would Transform The Pixels (tRNS, bKGD).
+static int readpng_parallel(vglImageData * image, struct png_source * src) {
+    struct png_restart_info info;
+    memset(&info, 0, sizeof(info));
+
+    int res = readpng_restart_scan(src, &info);
+    if( !res && info.rowbytes > SIZE_MAX / info.height )
+        res = OUT_OF_MEM_ERROR;
+    if( !res ) {
+        if((info.out = (png_bytep) malloc(info.rowbytes * info.height)) == NULL)
+            res = OUT_OF_MEM_ERROR;
+        else if((res = vglParallelFor(info.count, readpng_restart_segment, &info))) {
+            free(info.out);
+            info.out = NULL;
+        }
+    }
+    free(info.first_row);
+    free(info.offset);
+    free(info.stream);
+    if(res)
+        return PNG_NO_RESTARTS;
+
+    static const GLenum formats[7] = { GL_RED, 0, GL_RGB, 0, GL_RG, 0, GL_RGBA };
+    static const GLenum formats8[7] = { GL_R8, 0, GL_RGB8, 0, GL_RG8, 0, GL_RGBA8 };
+    static const GLenum formats_srgb[7] = { GL_R8, 0, GL_SRGB8, 0, GL_RG8, 0, GL_SRGB8_ALPHA8 };
+    static const GLenum formats16[7] = { GL_R16, 0, GL_RGB16, 0, GL_RG16, 0, GL_RGBA16 };
+    image->slices = 0;
+    image->target = GL_TEXTURE_2D;
+    image->SliceStride = 0;
+    image->mipmapCount = 1;
+    image->mip[0].width = info.width;
+    image->mip[0].height = info.height;
+    image->mip[0].mipStride = 0;
+    image->format = formats[info.color_type];
+    image->type = info.bit_depth == 16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+    image->internalFormat = info.bit_depth == 16 ? formats16[info.color_type] : info.srgb ? formats_srgb[info.color_type] : formats8[info.color_type];
+    image->TextureTotalSize = info.rowbytes * info.height;
+    image->mip[0].data = info.out;
+    return 0;
+}
+
+// Walks The Chunks Up To The First IDAT Looking For The Restart Chunk, Then Reads All IDAT Data Into Memory.
+static int readpng_restart_scan(struct png_source * src, struct png_restart_info * info) {
+    png_byte sig[8], head[8], ihdr[13];
+    if(readpng_src_read(src, sig, 8) != 8 || png_sig_cmp(sig, 0, 8))
+        return PNG_NO_RESTARTS;
+
+    int seen_ihdr = 0;
+    for(;;) {
+        if(readpng_src_read(src, head, 8) != 8)
+            return PNG_NO_RESTARTS;
+        png_uint_32 length = png_get_uint_32(head);
+        png_const_bytep type = head + 4;
+
+        if(memcmp(type, "IDAT", 4) == 0)
+            break;
+        if(memcmp(type, "IHDR", 4) == 0) {
+            if(length != 13 || readpng_src_read(src, ihdr, 13) != 13)
+                return PNG_NO_RESTARTS;
+            info->width = png_get_uint_32(ihdr);
+            info->height = png_get_uint_32(ihdr + 4);
+            info->bit_depth = ihdr[8];
+            info->color_type = ihdr[9];
+            // libpng's Size Limits Apply Here Too (No png_ptr Exists Yet, And The Loaders Never Change Them)
+            if(info->width > PNG_USER_WIDTH_MAX || info->height > PNG_USER_HEIGHT_MAX)
+                return PNG_NO_RESTARTS;
+            // Interlaced, Palette And Sub-Byte Images Go Through libpng
+            if(ihdr[12] != PNG_INTERLACE_NONE || (info->bit_depth != 8 && info->bit_depth != 16))
+                return PNG_NO_RESTARTS;
+            switch (info->color_type) {
+                case PNG_COLOR_TYPE_GRAY: info->channels = 1; break;
+                case PNG_COLOR_TYPE_GRAY_ALPHA: info->channels = 2; break;
+                case PNG_COLOR_TYPE_RGB: info->channels = 3; break;
+                case PNG_COLOR_TYPE_RGB_ALPHA: info->channels = 4; break;
+                default: return PNG_NO_RESTARTS;
+            }
+            info->bpp = info->channels * info->bit_depth / 8;
+            info->rowbytes = (size_t) info->width * info->bpp;
+            seen_ihdr = 1;
+            readpng_src_seek(src, 4, SEEK_CUR); // CRC
+        } else if(memcmp(type, PNG_RESTART_CHUNK, 4) == 0) {
+            png_byte count[4];
+            if(length < 4 || readpng_src_read(src, count, 4) != 4)
+                return PNG_NO_RESTARTS;
+            info->count = png_get_uint_32(count);
+            if(info->count == 0 || info->count > PNG_MAX_RESTARTS || length != 4 + 8 * info->count || info->first_row)
+                return PNG_NO_RESTARTS;
+
+            png_bytep payload = (png_bytep) malloc(length - 4);
+            info->first_row = (uint32_t *) malloc(info->count * sizeof(uint32_t));
+            info->offset = (uint32_t *) malloc(info->count * sizeof(uint32_t));
+            png_byte crc[4];
+            int ok = payload && info->first_row && info->offset && readpng_src_read(src, payload, length - 4) == length - 4 && readpng_src_read(src, crc, 4) == 4;
+            if(ok) {
+                uLong sum = crc32(crc32(crc32(0L, Z_NULL, 0), type, 4), count, 4);
+                ok = crc32(sum, payload, length - 4) == png_get_uint_32(crc);
+            }
+            for(uint32_t i = 0; ok && i < info->count; ++i) {
+                info->first_row[i] = png_get_uint_32(payload + 8 * i);
+                info->offset[i] = png_get_uint_32(payload + 8 * i + 4);
+            }
+            free(payload);
+            if( !ok )
+                return PNG_NO_RESTARTS;
+        } else if(memcmp(type, "gAMA", 4) == 0) {
+            png_byte gama[4];
+            if(length != 4 || readpng_src_read(src, gama, 4) != 4 || readpng_src_seek(src, 4, SEEK_CUR))
+                return PNG_NO_RESTARTS;
+            info->srgb |= readpng_is_srgb(0, 1, png_get_uint_32(gama) / 100000.0);
+        } else if(memcmp(type, "sRGB", 4) == 0) {
+            info->srgb = 1;
+            if(readpng_src_seek(src, (long) length + 4, SEEK_CUR))
+                return PNG_NO_RESTARTS;
+        } else if(memcmp(type, "tRNS", 4) == 0 || memcmp(type, "bKGD", 4) == 0)
+            return PNG_NO_RESTARTS; // libpng Would Transform These Pixels
+        else if(readpng_src_seek(src, (long) length + 4, SEEK_CUR))
+            return PNG_NO_RESTARTS;
+    }
+    if(!seen_ihdr || !info->first_row || info->width == 0 || info->height == 0)
+        return PNG_NO_RESTARTS;
+
+    // The Segments Must Tile The Image From Row 0 And Point Forward Into The Stream
+    for(uint32_t i = 0; i < info->count; ++i) {
+        if(i == 0 ? info->first_row[0] != 0 : (info->first_row[i] <= info->first_row[i - 1] || info->offset[i] <= info->offset[i - 1]))
+            return PNG_NO_RESTARTS;
+        if(info->first_row[i] >= info->height)
+            return PNG_NO_RESTARTS;
+    }
+
+    // Read The IDAT Data (The File Size Bounds It)
+    long start = readpng_src_tell(src) - 8;
+    readpng_src_seek(src, 0, SEEK_END);
+    long end = readpng_src_tell(src);
+    readpng_src_seek(src, start, SEEK_SET);
+    if(start < 0 || end <= start || (info->stream = (png_bytep) malloc(end - start)) == NULL)
+        return PNG_NO_RESTARTS;
+
+    while(readpng_src_read(src, head, 8) == 8 && memcmp(head + 4, "IDAT", 4) == 0) {
+        png_uint_32 length = png_get_uint_32(head);
+        png_byte crc[4];
+        if(length > (size_t) (end - start) - info->stream_len || readpng_src_read(src, info->stream + info->stream_len, length) != length || readpng_src_read(src, crc, 4) != 4)
+            return PNG_NO_RESTARTS;
+        if(crc32(crc32(crc32(0L, Z_NULL, 0), head + 4, 4), info->stream + info->stream_len, length) != png_get_uint_32(crc))
+            return PNG_NO_RESTARTS;
+        info->stream_len += length;
+    }
+
+    // zlib Header: Deflate, No Preset Dictionary. The Last Segment Must Start Inside The Stream.
+    if(info->stream_len < 2 || (info->stream[0] & 0x0f) != 8 || (info->stream[1] & 0x20) || info->offset[0] != 2 || info->offset[info->count - 1] >= info->stream_len)
+        return PNG_NO_RESTARTS;
+    return 0;
+}
+
+// Job: Inflates One Segment A Row At A Time And Unfilters It Into Its Rows Of The Output.
+static int readpng_restart_segment(void * user, size_t segment) {
+    struct png_restart_info * info = (struct png_restart_info *) user;
+    uint32_t first = info->first_row[segment];
+    uint32_t last = segment + 1 < info->count ? info->first_row[segment + 1] : info->height;
+    size_t in_end = segment + 1 < info->count ? info->offset[segment + 1] : info->stream_len;
+    if(in_end > info->stream_len)
+        return PNG_READ_ERROR;
+
+    png_bytep filtered = (png_bytep) malloc(info->rowbytes + 1);
+    if( !filtered )
+        return OUT_OF_MEM_ERROR;
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    if(inflateInit2(&strm, -15) != Z_OK) { // Raw Deflate, The zlib Header Belongs To The First Segment
+        free(filtered);
+        return OUT_OF_MEM_ERROR;
+    }
+    strm.next_in = info->stream + info->offset[segment];
+    strm.avail_in = in_end - info->offset[segment];
+
+    int res = 0;
+    for(uint32_t y = first; y < last && !res; ++y) {
+        strm.next_out = filtered;
+        strm.avail_out = info->rowbytes + 1;
+        while(strm.avail_out && !res) {
+            int z = inflate(&strm, Z_SYNC_FLUSH);
+            if(z != Z_OK && !(z == Z_STREAM_END && strm.avail_out == 0))
+                res = PNG_READ_ERROR;
+        }
+        if(res)
+            break;
+
+        png_bytep row = info->out + (size_t) y * info->rowbytes;
+        png_const_bytep prior = (y == first) ? NULL : row - info->rowbytes;
+        if(filtered[0] > PNG_FILTER_VALUE_PAETH || (prior == NULL && filtered[0] > PNG_FILTER_VALUE_SUB))
+            res = PNG_READ_ERROR; // Segment Start Depends On The Previous Segment
+        else
+            readpng_unfilter(filtered[0], row, filtered + 1, prior, info->rowbytes, info->bpp);
+    }
+
+    inflateEnd(&strm);
+    free(filtered);
+    return res;
+}
+
+// Reverses A PNG Row Filter (W3C PNG Spec. Section 9). `prior` Is NULL For A Segment's First Row.
+static void readpng_unfilter(int filter, png_bytep row, png_const_bytep src, png_const_bytep prior, size_t rowbytes, int bpp) {
+    size_t i;
+    switch (filter) {
+        case PNG_FILTER_VALUE_NONE:
+            memcpy(row, src, rowbytes);
+            break;
+        case PNG_FILTER_VALUE_SUB:
+            memcpy(row, src, bpp);
+            for(i = bpp; i < rowbytes; ++i)
+                row[i] = src[i] + row[i - bpp];
+            break;
+        case PNG_FILTER_VALUE_UP:
+            for(i = 0; i < rowbytes; ++i)
+                row[i] = src[i] + prior[i];
+            break;
+        case PNG_FILTER_VALUE_AVG:
+            for(i = 0; i < (size_t) bpp; ++i)
+                row[i] = src[i] + (prior[i] >> 1);
+            for(; i < rowbytes; ++i)
+                row[i] = src[i] + ((row[i - bpp] + prior[i]) >> 1);
+            break;
+        case PNG_FILTER_VALUE_PAETH:
+            for(i = 0; i < (size_t) bpp; ++i)
+                row[i] = src[i] + prior[i];
+            for(; i < rowbytes; ++i) {
+                int a = row[i - bpp], b = prior[i], c = prior[i - bpp];
+                int p = b - c, q = a - c;
+                int pa = abs(p), pb = abs(q), pc = abs(p + q);
+                row[i] = src[i] + ((pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c);
+            }
+            break;
+    }
+}
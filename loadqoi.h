@@ -1,21 +1,22 @@
+# ifndef _LITYPES
+    # include "image_types.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
 # include <stdio.h>
 # include <string.h>
 # include <stdlib.h>
 # include <stdint.h>
 
 
-# ifndef _LITYPES 
-    # include "image_types.h"
-# endif 
+# define _LIQOI 1
 
 // structs
 struct qoi_header {
-    char magic[4]; // Magic Number QOIF 
-    uint32_t width; // image width 
-    uint32_t height; // image height 
+    char magic[4]; // Magic Number QOIF
+    uint32_t width; // image width
+    uint32_t height; // image height
     uint8_t channels; // 3 = RGB, 4 = RGBA
     uint8_t colorspace; // 0 = sRGB with Linear Alpha
-                        // 1 = 1 all channels linear 
+                        // 1 = 1 all channels linear
 };
 
 struct color_cnk_4 {
@@ -30,267 +31,180 @@ struct color_cnk_3 {
     uint8_t b;
 };
 
+// Buffered Byte Reader. Reads From `fp` When It Is Set, Otherwise From The Memory Block [ptr, end).
+struct qoi_reader {
+    FILE * fp;
+    const uint8_t * ptr;
+    const uint8_t * end;
+    uint8_t buffer[4096];
+};
+
+// Decoder State Between Rows
+struct qoi_state {
+    struct color_cnk_4 color_array[64]; // Previously Seen Pixels
+    struct color_cnk_4 px; // Last Pixel
+    int run; // Pixels Left In The Current Run
+};
+
 // Functions
 int loadqoi(vglImageData *image, char *filename);
+int loadqoi_mem(vglImageData *image, const void *data, size_t size);
+int loadqoi_region(vglImageData *image, char *filename, GLsizei x, GLsizei y, GLsizei width, GLsizei height);
+int loadqoi_scaled(vglImageData *image, char *filename, GLsizei max_width, GLsizei max_height);
+int loadqoi_rows(vglImageData *image, char *filename, vglRowCallback callback, void * user);
 int is_qoi(char *filename);
 static uint8_t hash(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+static int readqoi_header(struct qoi_reader *reader, struct qoi_header *hdr, vglImageData *image);
+static int readqoi_image(struct qoi_reader *reader, vglImageData *image);
+static int readqoi_rows(struct qoi_reader *reader, const struct qoi_header *hdr, vglImageData *image, GLsizei last_row, vglRowCallback callback, void * user);
+static int readqoi_row(struct qoi_reader *reader, const struct qoi_header *hdr, struct qoi_state *state, uint8_t *out);
+static void readqoi_state_init(struct qoi_state *state);
+static void readqoi_reader_init(struct qoi_reader *reader, FILE *fp, const uint8_t *data, size_t size);
+static int readqoi_store_row(void * user, const vglImageData * image, GLsizei y, const GLvoid * row);
 
 
-// Errors 
+// Errors
 # define UNABLE_TO_OPEN_FILE 0x200
 # define INSUFFISCIENT_FILE_SIZE 0x400
 # define READ_FILE_ERROR 0x600
 # define NOT_QOI_SUPPORTED_FILE 0x105
 # define IMAGE_DOESNT_EXIST 19
+# define QOI_OUT_OF_MEM_ERROR 0x700
 
 // QOI Constants
-# define MAGIC_QOIF "qoif" 
+# define MAGIC_QOIF "qoif"
+# define QOI_HEADER_SIZE 14
 # define QOI_OP_RGB 0b11111110
 # define QOI_OP_RGBA 0b11111111
 # define QOI_OP_INDEX 0b00
 # define QOI_OP_DIFF 0b01
-# define QOI_OP_LUMA 0b10 
-# define QOI_OP_RUN 0b11 
+# define QOI_OP_LUMA 0b10
+# define QOI_OP_RUN 0b11
 
-// Load QOI File 
+// Load QOI File
 int loadqoi(vglImageData * image, char * filename) {
-   if ( !image )
-       return IMAGE_DOESNT_EXIST;
+    if ( !image )
+        return IMAGE_DOESNT_EXIST;
 
-
-
-    // Read The Contents Of The File :
+    // The File Is Streamed Through A Small Buffer Instead Of Being Read Whole
     FILE * infile;
     if(( infile = fopen(filename, "rb") ) == NULL)
         return UNABLE_TO_OPEN_FILE;
 
-    // Read The Length Of The FIle 
-    size_t len = 0;
-    fseek(infile, 0, SEEK_END);
-    len = ftell(infile);
-    fseek(infile, 0, SEEK_SET);
-    
-    if(len < 18) // Header: 14 Bytes + Min One Pixel 4 Bytes 
-        return INSUFFISCIENT_FILE_SIZE;
-    
-    // Reading Data 
-    ImageData contents = malloc(len);
-    if(fread(contents, 1, len, infile) != len)
-        return READ_FILE_ERROR;
-    
+    struct qoi_reader reader;
+    readqoi_reader_init(&reader, infile, NULL, 0);
+    int res = readqoi_image(&reader, image);
     fclose(infile);
+    return res;
+}
 
-    struct qoi_header hdr;
+// Load A QOI Image From Memory
+int loadqoi_mem(vglImageData * image, const void * data, size_t size) {
+    if ( !image || !data )
+        return IMAGE_DOESNT_EXIST;
 
-    char * char_img_ptr = (char *) contents;
+    struct qoi_reader reader;
+    readqoi_reader_init(&reader, NULL, (const uint8_t *) data, size);
+    return readqoi_image(&reader, image);
+}
 
-    // Check For QOI Signal
-    if(strncmp(char_img_ptr, MAGIC_QOIF, 4) != 0)
-        return NOT_QOI_SUPPORTED_FILE;
+// Decodes A Whole Image Into `image`
+static int readqoi_image(struct qoi_reader * reader, vglImageData * image) {
+    struct qoi_header hdr;
+    int res;
+    image->mip[0].data = NULL;
+    if((res = readqoi_header(reader, &hdr, image)))
+        return res;
+
+    if((image->mip[0].data = malloc(image->TextureTotalSize)) == NULL)
+        return QOI_OUT_OF_MEM_ERROR;
+
+    res = readqoi_rows(reader, &hdr, image, -1, readqoi_store_row, image->mip[0].data);
+    if(res) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    return res;
+}
 
-    contents = (ImageData) ( char_img_ptr += 4 );
-    
-    // Fill In Default Values
-    image->mipmapCount = 1;
-    image->type = GL_UNSIGNED_BYTE; // Yep QOI Uses 8-bit depth or less for specifying colors;
-    image->slices = 0; // No arrays 
-    image->SliceStride = 0;
-    image->target = GL_TEXTURE_2D; // Not 3D
+// Streams A QOI File Row By Row Through `callback` Instead Of Storing It. `image` Receives The Image Info But No Data.
+int loadqoi_rows(vglImageData * image, char * filename, vglRowCallback callback, void * user) {
+    if ( !image )
+        return IMAGE_DOESNT_EXIST;
 
-    // Reading the rest of the eader
-    uint32_t * uint32_img_ptr = (uint32_t *) contents;
-    image->mip[0].width = hdr.width = ReverseHexOrder_UINT32(*uint32_img_ptr++);
-    image->mip[0].height = hdr.height = ReverseHexOrder_UINT32(*uint32_img_ptr++);
-    contents = (ImageData) uint32_img_ptr;
+    FILE * infile;
+    if(( infile = fopen(filename, "rb") ) == NULL)
+        return UNABLE_TO_OPEN_FILE;
 
-    uint8_t * uint8_img_ptr = (uint8_t *) contents;
-    hdr.channels = *uint8_img_ptr++;
-    hdr.colorspace = *uint8_img_ptr;
+    struct qoi_reader reader;
+    readqoi_reader_init(&reader, infile, NULL, 0);
+    struct qoi_header hdr;
+    int res;
+    if(!(res = readqoi_header(&reader, &hdr, image)))
+        res = readqoi_rows(&reader, &hdr, image, -1, callback, user);
+    fclose(infile);
+    return res;
+}
 
-    if(hdr.channels == 3) {
-        image->format = GL_RGB;
-        image->internalFormat = GL_RGB8;
-    }
-    else if (hdr.channels == 4){
-        image->format = GL_RGBA;
-        image->internalFormat = GL_RGBA8;
-    }
-    else 
-        return NOT_QOI_SUPPORTED_FILE;
+// Loads Only The [x, x + width) * [y, y + height) Region Of A QOI File Into `image`.
+// QOI Has No Restart Points, So Every Pixel Up To The Region's Last Row Is Decoded, But Only Through One Row Buffer.
+int loadqoi_region(vglImageData * image, char * filename, GLsizei x, GLsizei y, GLsizei width, GLsizei height) {
+    if ( !image )
+        return IMAGE_DOESNT_EXIST;
+    if( !vgl_region_valid(x, y, width, height) )
+        return REGION_OUT_OF_BOUNDS_ERROR;
 
-    contents = (ImageData) uint8_img_ptr;
-
-    // Very Cool, now we need to read the rest of the file. *sigh*
-    size_t read_data_size = 0;
-    if(hdr.channels == 3) {
-        struct color_cnk_3 color_array[64] = { 0 };
-        
-        uint8_t data[hdr.width * hdr.height][3];
-        for(size_t i = 0; i < hdr.width * hdr.height && read_data_size < hdr.width * hdr.height * hdr.channels; ++i){
-            if(*uint8_img_ptr == QOI_OP_RGB) {
-                // Saves Pixel Data 
-                data[i][0] = *++uint8_img_ptr;
-                data[i][1] = *++uint8_img_ptr;
-                data[i][2] = *++uint8_img_ptr;
-
-                continue;
-            }
-            switch ((*uint8_img_ptr) >> 6) {
-                case QOI_OP_INDEX :
-                    uint8_t ind_cl; 
-                    ind_cl = ((*uint8_img_ptr++) << 2) >> 2;
-                    if(ind_cl < 0 || ind_cl > 64)
-                        return NOT_QOI_SUPPORTED_FILE;
-                    data[i][0] = color_array[ind_cl].r;
-                    data[i][1] = color_array[ind_cl].g;
-                    data[i][2] = color_array[ind_cl].b;
-                    break;
-                case QOI_OP_DIFF :
-                    if( i <= 0 )
-                        return NOT_QOI_SUPPORTED_FILE;
-                    int8_t dr, dg, db;
-                    dr = ((*uint8_img_ptr) << 2) >> 6;
-                    dg = ((*uint8_img_ptr) << 4) >> 6;
-                    db = ((*uint8_img_ptr++) << 6) >> 6;
-
-                    dr -= 2, dg -=2, db -= 2;
-                    data[i][0] = data[i - 1][0] - dr;
-                    data[i][1] = data[i - 1][1] - dg;
-                    data[i][2] = data[i - 1][2] - db;
+    FILE * infile;
+    if(( infile = fopen(filename, "rb") ) == NULL)
+        return UNABLE_TO_OPEN_FILE;
 
-                    break;
-                case QOI_OP_LUMA :
-                    int8_t diffG = *uint8_img_ptr++ << 2;
-                    int8_t dr_g, db_g;
-                    
-                    dr_g = *uint8_img_ptr >> 4;
-                    db_g = (*uint8_img_ptr++ << 4) >> 4;
-
-                    diffG -= 32;
-                    dr_g -= 8, db_g -= 8;
-
-                    data[i][1] = data[i - 1][1] - diffG;
-                    data[i][0] = dr_g - diffG + data[i-1][0];
-                    data[i][2] = db_g - diffG + data[i-1][2];
-                    break;
-                case QOI_OP_RUN :
-                    uint8_t len = *++uint8_img_ptr >> 2;
-                    if(len >= 63)
-                        return NOT_QOI_SUPPORTED_FILE;
-
-                    while(len-- > 0){
-                        data[i++][0] = data[i - 2][0];
-                        data[i++][1] = data[i - 2][1];
-                        data[i++][2] = data[i - 2][2];
-                    }
-                    break;
-            }
-            // Saves To Color Array 
-                uint8_t ind = hash(data[i][0], data[i][1], data[i][2], 255); // A: 255 Because the specification said the array should be init to {0, 0, 0, 255}.
-                color_array[ind].r = data[i][0];
-                color_array[ind].g = data[i][1];
-                color_array[ind].b = data[i][2];
-        }
-        image->mip[0].data = (ImageData) data;
-        return 0;
-    }   
-    // We Do Quite The Same Thing Again :)
-    if(hdr.channels == 4) {
-        struct color_cnk_4 color_array[64] = { 0 };
-
-        uint8_t data[hdr.width * hdr.height][4];
-        for(size_t i = 0; i < hdr.width * hdr.height && read_data_size < hdr.width * hdr.height * hdr.channels; ++i){
-            data[i][0] = 0, data[i][1] = 0, data[i][2] = 0, data[i][3] = 255; // Init 
-            if(*uint8_img_ptr == QOI_OP_RGB) {
-                // Saves Pixel Data 
-                data[i][0] = *++uint8_img_ptr;
-                data[i][1] = *++uint8_img_ptr;
-                data[i][2] = *++uint8_img_ptr;
-                data[i][3] = data[i - 1][3];
-                uint8_img_ptr++;
-
-                continue;
-            }
-            if(*uint8_img_ptr == QOI_OP_RGBA) {
-                
-                data[i][0] = *++uint8_img_ptr;
-                data[i][1] = *++uint8_img_ptr;
-                data[i][2] = *++uint8_img_ptr;
-                data[i][3] = *++uint8_img_ptr;
-                uint8_img_ptr++;
-
-                continue;
-            }
-            switch ((*uint8_img_ptr) >> 6) {
-                case QOI_OP_INDEX :
-                    uint8_t ind_cl; 
-                    ind_cl = ((*uint8_img_ptr++) << 2) >> 2;
-                    if(ind_cl < 0 || ind_cl > 64)
-                        return NOT_QOI_SUPPORTED_FILE;
-                    data[i][0] = color_array[ind_cl].r;
-                    data[i][1] = color_array[ind_cl].g;
-                    data[i][2] = color_array[ind_cl].b;
-                    data[i][3] = color_array[ind_cl].a;
-                    break;
-                case QOI_OP_DIFF :
-                    if( i <= 0 )
-                        return NOT_QOI_SUPPORTED_FILE;
-                    int8_t dr, dg, db;
-                    dr = ((*uint8_img_ptr) << 2) >> 6;
-                    dg = ((*uint8_img_ptr) << 4) >> 6;
-                    db = ((*uint8_img_ptr++) << 6) >> 6;
-
-                    dr -= 2, dg -=2, db -= 2;
-                    data[i][0] = data[i - 1][0] - dr;
-                    data[i][1] = data[i - 1][1] - dg;
-                    data[i][2] = data[i - 1][2] - db;
-                    data[i][3] = data[i - 1][3];
+    struct qoi_reader reader;
+    readqoi_reader_init(&reader, infile, NULL, 0);
+    struct qoi_header hdr;
+    struct vgl_region region = { x, y, width, height, 0, image };
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    int res;
+    image->mip[0].data = NULL;
+    if(!(res = readqoi_header(&reader, &hdr, &info)))
+        res = readqoi_rows(&reader, &hdr, &info, y + height - 1, vglRegionRow, &region);
+    fclose(infile);
 
-                    break;
-                case QOI_OP_LUMA :
-                    int8_t diffG = *uint8_img_ptr++ << 2;
-                    int8_t dr_g, db_g;
+    if(res && image->mip[0].data) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    return res;
+}
 
-                    dr_g = *uint8_img_ptr >> 4;
-                    db_g = (*uint8_img_ptr++ << 4) >> 4;
+// Loads A QOI File Box-Downsampled To Fit In max_width * max_height (See vglScaleRow), A Row At A Time.
+int loadqoi_scaled(vglImageData * image, char * filename, GLsizei max_width, GLsizei max_height) {
+    if ( !image )
+        return IMAGE_DOESNT_EXIST;
 
-                    diffG -= 32;
-                    dr_g -= 8, db_g -= 8;
+    FILE * infile;
+    if(( infile = fopen(filename, "rb") ) == NULL)
+        return UNABLE_TO_OPEN_FILE;
 
-                    data[i][1] = data[i - 1][1] - diffG;
-                    data[i][0] = dr_g - diffG + data[i-1][0];
-                    data[i][2] = db_g - diffG + data[i-1][2];
-                    data[i][3] = data[i - 1][3];
-                    break;
-                case QOI_OP_RUN :
-                    uint8_t len = *++uint8_img_ptr >> 2;
-                    if(len >= 63)
-                        return NOT_QOI_SUPPORTED_FILE;
-
-                    while(len-- > 0){
-                        data[i++][0] = data[i - 2][0];
-                        data[i++][1] = data[i - 2][1];
-                        data[i++][2] = data[i - 2][2];
-                        data[i++][3] = data[i - 2][3];
-                    }
-                    break;
-                default:
-                    return NOT_QOI_SUPPORTED_FILE;
-            }
-            // Saves To Color Array 
-            uint8_t ind = hash(data[i][0], data[i][1], data[i][2], 255); // A: 255 Because the specification said the array should be init to {0, 0, 0, 255}.
-            color_array[ind].r = data[i][0];
-            color_array[ind].g = data[i][1];
-            color_array[ind].b = data[i][2];
-            color_array[ind].a = data[i][3];
-        }
-        image->mip[0].data = (ImageData) data;
-        image->TextureTotalSize = hdr.width * hdr.height * hdr.channels;
-        return 0;
+    struct qoi_reader reader;
+    readqoi_reader_init(&reader, infile, NULL, 0);
+    struct qoi_header hdr;
+    struct vgl_scale scale = { max_width, max_height, 1, NULL, image };
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    int res;
+    image->mip[0].data = NULL;
+    if(!(res = readqoi_header(&reader, &hdr, &info)))
+        res = readqoi_rows(&reader, &hdr, &info, -1, vglScaleRow, &scale);
+    fclose(infile);
+    free(scale.sums);
+
+    if(res && image->mip[0].data) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
     }
-    
-    
-};
+    return res;
+}
 
 int unloadqoi(vglImageData * data) {
     if(data != NULL) {
@@ -298,20 +212,190 @@ int unloadqoi(vglImageData * data) {
     }
     return 0;
 }
-// Checks If A File Is QOI Or Not 
+// Checks If A File Is QOI Or Not
 int is_qoi(char * filename) {
     FILE * infile;
     if(( infile = fopen(filename, "rb") ) != NULL) {
-        char magic_sq[5];
+        char magic_sq[5] = { 0 };
         fread(magic_sq, 1, 4, infile);
-        magic_sq[4] = '\0';
         fclose(infile);
         return (strncmp(magic_sq, MAGIC_QOIF, 4) == 0) ? 0 : NOT_QOI_SUPPORTED_FILE;
     }
     return UNABLE_TO_OPEN_FILE;
 }
 
-// Generates A Hash Of Color Data 
+// Generates A Hash Of Color Data
 static uint8_t hash(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
     return (r * 3 + g * 5 + b * 7 + a * 11) % 64;
 }
+
+// Reads From `fp` (Through The Buffer) Or, When It's NULL, From The `size` Bytes At `data`
+static void readqoi_reader_init(struct qoi_reader * reader, FILE * fp, const uint8_t * data, size_t size) {
+    reader->fp = fp;
+    reader->ptr = data;
+    reader->end = data ? data + size : NULL;
+}
+
+// Returns The Next Byte Of The Stream, Or -1 When It Runs Out.
+static inline int qoi_byte(struct qoi_reader * reader) {
+    if(reader->ptr == reader->end) {
+        if( !reader->fp )
+            return -1;
+        size_t got = fread(reader->buffer, 1, sizeof(reader->buffer), reader->fp);
+        if(got == 0)
+            return -1;
+        reader->ptr = reader->buffer;
+        reader->end = reader->buffer + got;
+    }
+    return *reader->ptr++;
+}
+
+// Reads The 14 Byte Header And Fills In The Image Info
+static int readqoi_header(struct qoi_reader * reader, struct qoi_header * hdr, vglImageData * image) {
+    uint8_t raw[QOI_HEADER_SIZE];
+    for(size_t i = 0; i < QOI_HEADER_SIZE; ++i) {
+        int c = qoi_byte(reader);
+        if(c < 0)
+            return INSUFFISCIENT_FILE_SIZE;
+        raw[i] = (uint8_t) c;
+    }
+
+    // Check For QOI Signal
+    if(strncmp((char *) raw, MAGIC_QOIF, 4) != 0)
+        return NOT_QOI_SUPPORTED_FILE;
+    memcpy(hdr->magic, raw, 4);
+
+    // Width And Height Are Stored Big Endian
+    hdr->width = (uint32_t) raw[4] << 24 | (uint32_t) raw[5] << 16 | (uint32_t) raw[6] << 8 | raw[7];
+    hdr->height = (uint32_t) raw[8] << 24 | (uint32_t) raw[9] << 16 | (uint32_t) raw[10] << 8 | raw[11];
+    hdr->channels = raw[12];
+    hdr->colorspace = raw[13];
+    if(hdr->width == 0 || hdr->height == 0)
+        return NOT_QOI_SUPPORTED_FILE;
+
+    // Fill In Default Values
+    image->mipmapCount = 1;
+    image->type = GL_UNSIGNED_BYTE; // Yep QOI Uses 8-bit depth or less for specifying colors;
+    image->slices = 0; // No arrays
+    image->SliceStride = 0;
+    image->target = GL_TEXTURE_2D; // Not 3D
+    image->mip[0].width = hdr->width;
+    image->mip[0].height = hdr->height;
+
+    // Colorspace 0 Is sRGB (With Linear Alpha), Which The GPU Decodes For Us
+    if(hdr->channels == 3) {
+        image->format = GL_RGB;
+        image->internalFormat = hdr->colorspace == 0 ? GL_SRGB8 : GL_RGB8;
+    }
+    else if (hdr->channels == 4){
+        image->format = GL_RGBA;
+        image->internalFormat = hdr->colorspace == 0 ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+    }
+    else
+        return NOT_QOI_SUPPORTED_FILE;
+
+    image->TextureTotalSize = (GLsizeiptr) hdr->width * hdr->height * hdr->channels;
+    return 0;
+}
+
+// Decodes One Row Of The Pixel Stream Into `out`. `state` Carries The Decoder Across Rows.
+static int readqoi_row(struct qoi_reader * reader, const struct qoi_header * hdr, struct qoi_state * state, uint8_t * out) {
+    struct color_cnk_4 px = state->px;
+    int run = state->run, res = 0;
+    for(uint32_t x = 0; x < hdr->width; ++x, out += hdr->channels) {
+        if(run > 0)
+            --run;
+        else {
+            int b1 = qoi_byte(reader), b2;
+            if(b1 < 0) {
+                res = READ_FILE_ERROR;
+                break;
+            }
+            if(b1 == QOI_OP_RGB || b1 == QOI_OP_RGBA) {
+                int r = qoi_byte(reader), g = qoi_byte(reader), b = qoi_byte(reader);
+                int a = (b1 == QOI_OP_RGBA) ? qoi_byte(reader) : px.a;
+                if((r | g | b | a) < 0) {
+                    res = READ_FILE_ERROR;
+                    break;
+                }
+                px.r = r, px.g = g, px.b = b, px.a = a;
+            } else {
+                switch (b1 >> 6) {
+                    case QOI_OP_INDEX :
+                        px = state->color_array[b1 & 0x3f];
+                        break;
+                    case QOI_OP_DIFF :
+                        px.r += ((b1 >> 4) & 0x03) - 2;
+                        px.g += ((b1 >> 2) & 0x03) - 2;
+                        px.b += (b1 & 0x03) - 2;
+                        break;
+                    case QOI_OP_LUMA : {
+                        if((b2 = qoi_byte(reader)) < 0) {
+                            res = READ_FILE_ERROR;
+                            break;
+                        }
+                        int diffG = (b1 & 0x3f) - 32;
+                        px.r += diffG - 8 + ((b2 >> 4) & 0x0f);
+                        px.g += diffG;
+                        px.b += diffG - 8 + (b2 & 0x0f);
+                        break;
+                    }
+                    case QOI_OP_RUN :
+                        run = b1 & 0x3f; // Stored With A Bias Of -1, This Pixel Is The First Of The Run
+                        break;
+                }
+                if(res)
+                    break;
+            }
+            // Saves To Color Array
+            state->color_array[hash(px.r, px.g, px.b, px.a)] = px;
+        }
+
+        out[0] = px.r;
+        out[1] = px.g;
+        out[2] = px.b;
+        if(hdr->channels == 4)
+            out[3] = px.a;
+    }
+    state->px = px;
+    state->run = run;
+    return res;
+}
+
+// Decodes The Pixel Stream One Row At A Time And Hands Each Row To `callback`.
+// Stops After `last_row` (A Negative `last_row` Means The Whole Image).
+static int readqoi_rows(struct qoi_reader * reader, const struct qoi_header * hdr, vglImageData * image, GLsizei last_row, vglRowCallback callback, void * user) {
+    if(last_row < 0)
+        last_row = hdr->height - 1;
+    if((uint32_t) last_row >= hdr->height)
+        return REGION_OUT_OF_BOUNDS_ERROR;
+
+    size_t rowbytes = (size_t) hdr->width * hdr->channels;
+    uint8_t * row = (uint8_t *) malloc(rowbytes);
+    if( !row )
+        return QOI_OUT_OF_MEM_ERROR;
+
+    struct qoi_state state;
+    readqoi_state_init(&state);
+    int res = 0;
+    for(GLsizei y = 0; y <= last_row && !res; ++y)
+        if( !(res = readqoi_row(reader, hdr, &state, row)) )
+            res = callback(user, image, y, row);
+
+    free(row);
+    return res == VGL_ROW_STOP ? 0 : res;
+}
+
+static void readqoi_state_init(struct qoi_state * state) {
+    memset(state->color_array, 0, sizeof(state->color_array));
+    state->px.r = state->px.g = state->px.b = 0;
+    state->px.a = 255;
+    state->run = 0;
+}
+
+// Row Callback Copying Each Row Into A Full Image Buffer
+static int readqoi_store_row(void * user, const vglImageData * image, GLsizei y, const GLvoid * row) {
+    size_t rowbytes = (size_t) image->mip[0].width * vglPixelSize(image);
+    memcpy((uint8_t *) user + (size_t) y * rowbytes, row, rowbytes);
+    return 0;
+}
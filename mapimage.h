@@ -0,0 +1,92 @@
+// Out-Of-Core Loading. Images Are Decoded Straight Into A File (Rows Are Appended As The Decoder Streams Them,
+// So It's Written Sequentially) Which Is Then Memory-Mapped, So Images Larger Than RAM Can Still Be Loaded (POSIX Only).
+# ifndef _LIIMAGE
+    # include "loadimage.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+
+# define _LIMAP 1
+
+# define VGL_MAP_BUFFER_SIZE (1 << 20) // Rows Are Gathered Into Writes Of This Size
+
+// Errors
+# define MAP_OPEN_ERROR 0xC00
+# define MAP_WRITE_ERROR 0xC01
+# define MAP_MMAP_ERROR 0xC02
+
+// Functions
+int vglLoadMapped(char *filename, char *target, vglImageData *out);
+int vglUnloadMapped(vglImageData *image);
+
+// State Of An Out-Of-Core Load
+struct vgl_map_writer {
+    FILE * fp;
+    vglImageData * out;
+};
+
+// Appends Every Row To The Target File
+static int vgl_map_row(void * user, const vglImageData * image, GLsizei y, const GLvoid * row) {
+    struct vgl_map_writer * writer = (struct vgl_map_writer *) user;
+    size_t rowbytes = (size_t) image->mip[0].width * vglPixelSize(image);
+    if(y == 0) {
+        *writer->out = *image;
+        writer->out->TextureTotalSize = (GLsizeiptr) rowbytes * image->mip[0].height;
+    }
+    return fwrite(row, 1, rowbytes, writer->fp) == rowbytes ? 0 : MAP_WRITE_ERROR;
+}
+
+// Decodes An Image Into `target` (Raw Rows, No Header. A NULL `target` Uses An Anonymous Temporary File In $TMPDIR)
+// And Maps It Into `out->mip[0].data`. The Mapping Is Shared, So Changes Go Back To `target`. Free It With vglUnloadMapped().
+int vglLoadMapped(char * filename, char * target, vglImageData * out) {
+    if( !out )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    out->mip[0].data = NULL;
+
+    int fd;
+    if(target)
+        fd = open(target, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    else {
+        const char * dir = getenv("TMPDIR");
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/vglimage-XXXXXX", dir ? dir : "/tmp");
+        if((fd = mkstemp(path)) >= 0)
+            unlink(path); // Gone As Soon As It's Unmapped
+    }
+    if(fd < 0)
+        return MAP_OPEN_ERROR;
+
+    struct vgl_map_writer writer = { fdopen(fd, "w+b"), out };
+    if( !writer.fp ) {
+        close(fd);
+        return MAP_OPEN_ERROR;
+    }
+    setvbuf(writer.fp, NULL, _IOFBF, VGL_MAP_BUFFER_SIZE);
+
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    int res = vglLoadRows(filename, &info, vgl_map_row, &writer);
+    if( !res && fflush(writer.fp) != 0)
+        res = MAP_WRITE_ERROR;
+    if( !res ) {
+        void * data = mmap(NULL, (size_t) out->TextureTotalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(writer.fp), 0);
+        if(data == MAP_FAILED)
+            res = MAP_MMAP_ERROR;
+        else
+            out->mip[0].data = data;
+    }
+    fclose(writer.fp); // The Mapping Keeps The File Alive
+    return res;
+}
+
+int vglUnloadMapped(vglImageData * image) {
+    if( image && image->mip[0].data ) {
+        munmap(image->mip[0].data, (size_t) image->TextureTotalSize);
+        image->mip[0].data = NULL;
+    }
+    return 0;
+}
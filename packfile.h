@@ -0,0 +1,357 @@
+// Pack Archives. Many Small Images In One File That Is Mapped Once, So Loading An Entry Costs A Lookup And A Decode
+// Instead Of An fopen()/fstat()/fclose() Each (POSIX Only). Build Them With vglPackBuild() Or tools/vglpack.c.
+// Little-Endian Layout:
+//      Header  { char magic[8] = "VGLPACK1", uint32 count, uint32 flags, uint64 index_offset, uint64 names_offset }
+//      Index   count * { uint64 hash, uint64 offset, uint64 size, uint32 name, uint32 kind }, Sorted By hash (FNV-1a 64 Of The Name)
+//      Names   NUL-Terminated Entry Names, Indexed By `name`
+//      Payload Every Entry Starts On A VGL_PACK_ALIGN Boundary. Encoded Entries Hold The Original PNG/JPEG/QOI Bytes,
+//              Decoded Entries A VGL_PACK_ALIGN Byte Header { uint32 width, height, format, type, internalFormat } Then The Pixels.
+# ifndef _LIIMAGE
+    # include "loadimage.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdio.h>
+# include <stdlib.h>
+# include <stdint.h>
+# include <string.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+
+# define _LIPACK 1
+
+# define VGL_PACK_MAGIC "VGLPACK1"
+# define VGL_PACK_HEADER_SIZE 32
+# define VGL_PACK_ENTRY_SIZE 32
+# define VGL_PACK_ALIGN 64 // Payload Alignment (Decoded Pixels Start On A Cache Line)
+
+// Entry Kinds
+# define VGL_PACK_ENCODED 0
+# define VGL_PACK_DECODED 1
+
+// Errors
+# define PACK_OPEN_ERROR 0xF00
+# define PACK_BAD_ARCHIVE_ERROR 0xF01
+# define PACK_NOT_FOUND_ERROR 0xF02
+# define PACK_WRITE_ERROR 0xF03
+# define PACK_OUT_OF_MEM_ERROR 0xF04
+# define PACK_DUPLICATE_NAME_ERROR 0xF05 // Two Files Were Given The Same Name
+
+// An Open Archive
+typedef struct {
+    const unsigned char * base; // The Mapping
+    size_t size;
+    uint32_t count;
+    const unsigned char * index;
+    const char * names;
+    size_t names_size;
+} vglPack;
+
+// Functions
+int vglPackOpen(vglPack *pack, const char *filename);
+int vglPackClose(vglPack *pack);
+int vglPackFind(const vglPack *pack, const char *name, const void **data, size_t *size, int *kind);
+int vglPackLoad(const vglPack *pack, const char *name, vglImageData *out);
+int vglPackView(const vglPack *pack, const char *name, vglImageData *out);
+int vglPackBuild(const char *archive, char **files, const char **names, int count, int decode);
+
+static uint64_t vgl_pack_hash(const char * name) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while(*name)
+        h = (h ^ (unsigned char) *name++) * 0x100000001b3ULL;
+    return h;
+}
+
+static uint32_t vgl_pack_u32(const unsigned char * p) {
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static uint64_t vgl_pack_u64(const unsigned char * p) {
+    return (uint64_t) vgl_pack_u32(p) | (uint64_t) vgl_pack_u32(p + 4) << 32;
+}
+
+static void vgl_pack_put_u32(unsigned char * p, uint32_t v) {
+    p[0] = (unsigned char) v, p[1] = (unsigned char) (v >> 8), p[2] = (unsigned char) (v >> 16), p[3] = (unsigned char) (v >> 24);
+}
+
+static void vgl_pack_put_u64(unsigned char * p, uint64_t v) {
+    vgl_pack_put_u32(p, (uint32_t) v);
+    vgl_pack_put_u32(p + 4, (uint32_t) (v >> 32));
+}
+
+// Maps An Archive And Checks Its Header And Index
+int vglPackOpen(vglPack * pack, const char * filename) {
+    memset(pack, 0, sizeof(*pack));
+    int fd = open(filename, O_RDONLY);
+    if(fd < 0)
+        return PACK_OPEN_ERROR;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < VGL_PACK_HEADER_SIZE) {
+        close(fd);
+        return PACK_BAD_ARCHIVE_ERROR;
+    }
+    void * base = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The Mapping Keeps The File Open
+    if(base == MAP_FAILED)
+        return PACK_OPEN_ERROR;
+
+    const unsigned char * p = (const unsigned char *) base;
+    size_t size = (size_t) st.st_size;
+    uint32_t count = vgl_pack_u32(p + 8);
+    uint64_t index = vgl_pack_u64(p + 16), names = vgl_pack_u64(p + 24);
+    if(memcmp(p, VGL_PACK_MAGIC, 8) != 0 || index > size || count > (size - index) / VGL_PACK_ENTRY_SIZE ||
+       names < index + (uint64_t) count * VGL_PACK_ENTRY_SIZE || names > size) {
+        munmap(base, size);
+        return PACK_BAD_ARCHIVE_ERROR;
+    }
+
+    pack->base = p;
+    pack->size = size;
+    pack->count = count;
+    pack->index = p + index;
+    pack->names = (const char *) p + names;
+    pack->names_size = size - names;
+    return 0;
+}
+
+int vglPackClose(vglPack * pack) {
+    if(pack->base)
+        munmap((void *) pack->base, pack->size);
+    memset(pack, 0, sizeof(*pack));
+    return 0;
+}
+
+// Finds An Entry By Name (Binary Search On The Name Hash). `data` Points Into The Mapping.
+int vglPackFind(const vglPack * pack, const char * name, const void ** data, size_t * size, int * kind) {
+    uint64_t hash = vgl_pack_hash(name);
+    size_t lo = 0, hi = pack->count;
+    while(lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if(vgl_pack_u64(pack->index + mid * VGL_PACK_ENTRY_SIZE) < hash)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // Entries Sharing The Hash Are Told Apart By Name
+    for(; lo < pack->count; ++lo) {
+        const unsigned char * entry = pack->index + lo * VGL_PACK_ENTRY_SIZE;
+        if(vgl_pack_u64(entry) != hash)
+            break;
+        uint32_t name_offset = vgl_pack_u32(entry + 24);
+        if(name_offset >= pack->names_size || strncmp(pack->names + name_offset, name, pack->names_size - name_offset) != 0)
+            continue;
+
+        uint64_t offset = vgl_pack_u64(entry + 8), length = vgl_pack_u64(entry + 16);
+        if(offset > pack->size || length > pack->size - offset)
+            return PACK_BAD_ARCHIVE_ERROR;
+        *data = pack->base + offset;
+        *size = (size_t) length;
+        if(kind)
+            *kind = (int) vgl_pack_u32(entry + 28);
+        return 0;
+    }
+    return PACK_NOT_FOUND_ERROR;
+}
+
+// Describes A Decoded Entry, Pointing `out` At Its Pixels In The Mapping
+static int vgl_pack_decoded(const unsigned char * data, size_t size, vglImageData * out) {
+    if(size < VGL_PACK_ALIGN)
+        return PACK_BAD_ARCHIVE_ERROR;
+    memset(out, 0, sizeof(*out));
+    out->target = GL_TEXTURE_2D;
+    out->mipmapCount = 1;
+    uint32_t width = vgl_pack_u32(data), height = vgl_pack_u32(data + 4);
+    out->format = vgl_pack_u32(data + 8);
+    out->type = vgl_pack_u32(data + 12);
+    out->internalFormat = vgl_pack_u32(data + 16);
+
+    // The Header Comes From The Archive: The Pixels Must Fill The Payload Exactly, Without The Product Wrapping
+    size_t ps = vglPixelSize(out), pixels = size - VGL_PACK_ALIGN;
+    if(width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX || ps == 0 ||
+       (size_t) width > pixels / ps || (size_t) width * ps > pixels / height || (size_t) width * ps * height != pixels)
+        return PACK_BAD_ARCHIVE_ERROR;
+    out->mip[0].width = (GLsizei) width;
+    out->mip[0].height = (GLsizei) height;
+    out->TextureTotalSize = (GLsizeiptr) pixels;
+    out->mip[0].data = (GLvoid *) (data + VGL_PACK_ALIGN);
+    return 0;
+}
+
+// Loads An Entry Into A New Image (Decoding Encoded Entries From The Mapping). Free It With free(out->mip[0].data).
+int vglPackLoad(const vglPack * pack, const char * name, vglImageData * out) {
+    const void * data;
+    size_t size;
+    int kind, res;
+    out->mip[0].data = NULL;
+    if((res = vglPackFind(pack, name, &data, &size, &kind)))
+        return res;
+    if(kind == VGL_PACK_ENCODED)
+        return vglLoadMemory(data, size, out);
+
+    vglImageData view;
+    if((res = vgl_pack_decoded((const unsigned char *) data, size, &view)))
+        return res;
+    *out = view;
+    if((out->mip[0].data = malloc((size_t) view.TextureTotalSize)) == NULL)
+        return PACK_OUT_OF_MEM_ERROR;
+    memcpy(out->mip[0].data, view.mip[0].data, (size_t) view.TextureTotalSize);
+    return 0;
+}
+
+// Points `out` At A Decoded Entry's Pixels Inside The Mapping (No Copy, Read-Only, Valid Until vglPackClose()).
+// Encoded Entries Are Decoded Like vglPackLoad() Does, So Only Those Need free(out->mip[0].data).
+int vglPackView(const vglPack * pack, const char * name, vglImageData * out) {
+    const void * data;
+    size_t size;
+    int kind, res;
+    out->mip[0].data = NULL;
+    if((res = vglPackFind(pack, name, &data, &size, &kind)))
+        return res;
+    if(kind == VGL_PACK_ENCODED)
+        return vglLoadMemory(data, size, out);
+    return vgl_pack_decoded((const unsigned char *) data, size, out);
+}
+
+// Builder Entry
+struct vgl_pack_item {
+    uint64_t hash;
+    const char * name;
+    char * file;
+    uint64_t offset, size;
+    uint32_t name_offset;
+};
+
+static int vgl_pack_item_cmp(const void * a, const void * b) {
+    const struct vgl_pack_item * x = (const struct vgl_pack_item *) a, * y = (const struct vgl_pack_item *) b;
+    if(x->hash != y->hash)
+        return x->hash < y->hash ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+// Reads A Whole File
+static unsigned char * vgl_pack_read(const char * filename, size_t * size) {
+    FILE * fp = fopen(filename, "rb");
+    if( !fp )
+        return NULL;
+    unsigned char * data = NULL;
+    long len;
+    if(fseek(fp, 0, SEEK_END) == 0 && (len = ftell(fp)) >= 0 && fseek(fp, 0, SEEK_SET) == 0 &&
+       (data = (unsigned char *) malloc(len ? (size_t) len : 1)) != NULL && fread(data, 1, (size_t) len, fp) != (size_t) len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(fp);
+    *size = (size_t) len;
+    return data;
+}
+
+// Pads The Archive To The Next Payload Boundary
+static int vgl_pack_pad(FILE * fp, uint64_t * pos) {
+    static const unsigned char zeros[VGL_PACK_ALIGN] = { 0 };
+    size_t pad = (size_t) ((VGL_PACK_ALIGN - *pos % VGL_PACK_ALIGN) % VGL_PACK_ALIGN);
+    *pos += pad;
+    return fwrite(zeros, 1, pad, fp) == pad ? 0 : PACK_WRITE_ERROR;
+}
+
+// Writes `count` Files Into A New Archive Under `names` (NULL Uses The File Paths). With `decode` Set, Images Are Stored
+// Decoded (Bigger, But Loading Them Is A memcpy, Or Nothing With vglPackView()). Otherwise Their Bytes Are Stored As They Are.
+int vglPackBuild(const char * archive, char ** files, const char ** names, int count, int decode) {
+    struct vgl_pack_item * items = (struct vgl_pack_item *) calloc(count > 0 ? (size_t) count : 1, sizeof(*items));
+    if( !items )
+        return PACK_OUT_OF_MEM_ERROR;
+    uint64_t names_size = 0;
+    for(int i = 0; i < count; ++i) {
+        items[i].file = files[i];
+        items[i].name = names ? names[i] : files[i];
+        items[i].hash = vgl_pack_hash(items[i].name);
+    }
+    qsort(items, (size_t) count, sizeof(*items), vgl_pack_item_cmp);
+    for(int i = 1; i < count; ++i)
+        if(items[i].hash == items[i - 1].hash && strcmp(items[i].name, items[i - 1].name) == 0) { // Lookups Would Only Ever Find One
+            free(items);
+            return PACK_DUPLICATE_NAME_ERROR;
+        }
+    for(int i = 0; i < count; ++i) {
+        items[i].name_offset = (uint32_t) names_size;
+        names_size += strlen(items[i].name) + 1;
+    }
+
+    FILE * fp = fopen(archive, "wb");
+    if( !fp ) {
+        free(items);
+        return PACK_OPEN_ERROR;
+    }
+
+    // Payloads First (Behind Room For The Header, Index And Names), Since Their Sizes Aren't Known Until They're Read
+    uint64_t index_offset = VGL_PACK_HEADER_SIZE, names_offset = index_offset + (uint64_t) count * VGL_PACK_ENTRY_SIZE;
+    uint64_t pos = names_offset + names_size;
+    int res = fseek(fp, (long) pos, SEEK_SET) ? PACK_WRITE_ERROR : 0;
+    for(int i = 0; i < count && !res; ++i) {
+        if((res = vgl_pack_pad(fp, &pos)))
+            break;
+        items[i].offset = pos;
+        if(decode) {
+            vglImageData image;
+            memset(&image, 0, sizeof(image));
+            unsigned char head[VGL_PACK_ALIGN] = { 0 };
+            if((res = vglLoad(items[i].file, &image)))
+                break;
+            vgl_pack_put_u32(head, (uint32_t) image.mip[0].width);
+            vgl_pack_put_u32(head + 4, (uint32_t) image.mip[0].height);
+            vgl_pack_put_u32(head + 8, image.format);
+            vgl_pack_put_u32(head + 12, image.type);
+            vgl_pack_put_u32(head + 16, image.internalFormat);
+            items[i].size = VGL_PACK_ALIGN + (uint64_t) image.TextureTotalSize;
+            if(fwrite(head, 1, VGL_PACK_ALIGN, fp) != VGL_PACK_ALIGN ||
+               fwrite(image.mip[0].data, 1, (size_t) image.TextureTotalSize, fp) != (size_t) image.TextureTotalSize)
+                res = PACK_WRITE_ERROR;
+            free(image.mip[0].data);
+        } else {
+            size_t size;
+            unsigned char * data = vgl_pack_read(items[i].file, &size);
+            if( !data ) {
+                res = PACK_OPEN_ERROR;
+                break;
+            }
+            items[i].size = size;
+            if(fwrite(data, 1, size, fp) != size)
+                res = PACK_WRITE_ERROR;
+            free(data);
+        }
+        pos += items[i].size;
+    }
+
+    // Then The Header, Index And Names
+    if( !res && fseek(fp, 0, SEEK_SET))
+        res = PACK_WRITE_ERROR;
+    if( !res ) {
+        unsigned char head[VGL_PACK_HEADER_SIZE] = { 0 };
+        memcpy(head, VGL_PACK_MAGIC, 8);
+        vgl_pack_put_u32(head + 8, (uint32_t) count);
+        vgl_pack_put_u64(head + 16, index_offset);
+        vgl_pack_put_u64(head + 24, names_offset);
+        if(fwrite(head, 1, sizeof(head), fp) != sizeof(head))
+            res = PACK_WRITE_ERROR;
+    }
+    for(int i = 0; i < count && !res; ++i) {
+        unsigned char entry[VGL_PACK_ENTRY_SIZE];
+        vgl_pack_put_u64(entry, items[i].hash);
+        vgl_pack_put_u64(entry + 8, items[i].offset);
+        vgl_pack_put_u64(entry + 16, items[i].size);
+        vgl_pack_put_u32(entry + 24, items[i].name_offset);
+        vgl_pack_put_u32(entry + 28, decode ? VGL_PACK_DECODED : VGL_PACK_ENCODED);
+        if(fwrite(entry, 1, sizeof(entry), fp) != sizeof(entry))
+            res = PACK_WRITE_ERROR;
+    }
+    for(int i = 0; i < count && !res; ++i)
+        if(fwrite(items[i].name, 1, strlen(items[i].name) + 1, fp) != strlen(items[i].name) + 1)
+            res = PACK_WRITE_ERROR;
+
+    if(fclose(fp) != 0 && !res)
+        res = PACK_WRITE_ERROR;
+    if(res)
+        remove(archive);
+    free(items);
+    return res;
+}
@@ -0,0 +1,84 @@
+// Tiny Parallel-For Helper Shared By The Multithreaded Loaders/Writers (Needs -pthread).
+# include <stdlib.h>
+# include <unistd.h>
+# include <pthread.h>
+
+# define _LIPARALLEL 1
+
+# define VGL_MAX_THREADS 64
+
+// Job Function. Returns 0 On Success, Any Other Value Cancels The Remaining Jobs And Is Returned By vglParallelFor().
+typedef int (*vglParallelJob)(void * user, size_t job);
+
+// Functions
+int vglThreadCount(void);
+int vglParallelFor(size_t count, vglParallelJob job, void * user);
+
+// Shared State Of A vglParallelFor() Call
+struct vgl_parallel {
+    pthread_mutex_t lock;
+    size_t next, count;
+    int result;
+    vglParallelJob job;
+    void * user;
+};
+
+// Number Of Worker Threads To Use. The VGL_THREADS Environment Variable Overrides The CPU Count.
+int vglThreadCount(void) {
+    char * p;
+    long threads;
+    if((p = getenv("VGL_THREADS")) != NULL)
+        threads = atol(p);
+    else
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads < 1)
+        threads = 1;
+    return threads > VGL_MAX_THREADS ? VGL_MAX_THREADS : (int) threads;
+}
+
+// Worker Loop, Pulls Jobs Until They Run Out Or One Fails
+static void * vgl_parallel_worker(void * arg) {
+    struct vgl_parallel * state = (struct vgl_parallel *) arg;
+    for(;;) {
+        pthread_mutex_lock(&state->lock);
+        size_t job = state->next++;
+        int stop = state->result != 0 || job >= state->count;
+        pthread_mutex_unlock(&state->lock);
+        if(stop)
+            return NULL;
+
+        int res = state->job(state->user, job);
+        if(res) {
+            pthread_mutex_lock(&state->lock);
+            if( !state->result )
+                state->result = res;
+            pthread_mutex_unlock(&state->lock);
+        }
+    }
+}
+
+// Runs job(user, 0) ... job(user, count - 1) Across vglThreadCount() Threads (The Calling Thread Included).
+int vglParallelFor(size_t count, vglParallelJob job, void * user) {
+    struct vgl_parallel state;
+    pthread_t threads[VGL_MAX_THREADS];
+    int i, spawned = 0, wanted = vglThreadCount();
+    if((size_t) wanted > count)
+        wanted = (int) count;
+
+    pthread_mutex_init(&state.lock, NULL);
+    state.next = 0;
+    state.count = count;
+    state.result = 0;
+    state.job = job;
+    state.user = user;
+
+    for(i = 1; i < wanted; ++i)
+        if(pthread_create(&threads[spawned], NULL, vgl_parallel_worker, &state) == 0)
+            ++spawned; // If We Can't Get A Thread The Others Just Take More Jobs
+    vgl_parallel_worker(&state);
+    for(i = 0; i < spawned; ++i)
+        pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&state.lock);
+    return state.result;
+}
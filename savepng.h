@@ -0,0 +1,390 @@
+// PNG Writer. Rows Are Filtered And Deflated In Independent Chunks Across Threads (pigz-Style),
+// Then The Chunks Are Stitched Into One Ordinary zlib Stream That Every PNG Decoder Reads.
+# ifndef _LITYPES
+    # include "image_types.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdint.h>
+# include <zlib.h>
+
+# ifndef _LIPARALLEL
+    # include "parallel.h"
+# endif
+
+# define _LISAVEPNG 1
+
+// Row Filters (W3C PNG Spec. Section 9), VGL_PNG_FILTER_ADAPTIVE Picks The Best One For Every Row
+# define VGL_PNG_FILTER_NONE 0
+# define VGL_PNG_FILTER_SUB 1
+# define VGL_PNG_FILTER_UP 2
+# define VGL_PNG_FILTER_AVG 3
+# define VGL_PNG_FILTER_PAETH 4
+# define VGL_PNG_FILTER_ADAPTIVE 5
+
+// Defaults
+# define VGL_PNG_DEFAULT_LEVEL 6
+# define VGL_PNG_CHUNK_BYTES 0x20000 // Uncompressed Bytes Per Chunk When chunkRows Is 0 (pigz Uses 128K Too)
+# define VGL_PNG_MAX_CHUNKS 0x10000
+# define VGL_PNG_WINDOW 0x8000 // Deflate Window, Each Chunk Is Primed With This Much Of The Previous Chunk
+
+// Errors
+# define IMAGE_DOESNT_EXIST_ERROR 19
+# define SAVEPNG_UNSUPPORTED_FORMAT_ERROR 0xA00
+# define SAVEPNG_OUT_OF_MEM_ERROR 0xA01
+# define SAVEPNG_WRITE_ERROR 0xA02
+# define SAVEPNG_DEFLATE_ERROR 0xA03
+
+// Writer Options. A NULL Options Pointer Means { VGL_PNG_DEFAULT_LEVEL, VGL_PNG_FILTER_ADAPTIVE, 0, 0 }.
+typedef struct {
+    int level; // zlib Compression Level 0-9
+    int filter; // One Of VGL_PNG_FILTER_*
+    GLsizei chunkRows; // Rows Per Compression Chunk (0 Picks ~VGL_PNG_CHUNK_BYTES Worth)
+    int restarts; // Write A Restart Chunk (vgRS) So loadpng() Can Decode The File In Parallel.
+                  // Chunks Are Then Compressed Without Each Other's History, Which Costs A Little Ratio.
+} vglPngOptions;
+
+// Functions
+int savepng(const vglImageData *image, char *filename, const vglPngOptions *options);
+int savepng_mem(const vglImageData *image, void **buffer, size_t *size, const vglPngOptions *options);
+
+// One Compressed Chunk
+struct savepng_chunk {
+    Bytef * data; // Raw Deflate Data (The First Chunk Has Room For The zlib Header, The Last One For The Adler-32)
+    size_t len;
+    uLong adler; // Adler-32 Of The Chunk's Filtered Bytes
+    size_t raw_len;
+};
+
+// State Shared By The Compression Jobs
+struct savepng_state {
+    const GLubyte * pixels;
+    size_t rowbytes;
+    int bpp;
+    GLsizei height;
+    GLsizei chunk_rows;
+    size_t chunks;
+    int level, filter, restarts;
+    struct savepng_chunk * out;
+};
+
+// Output Sink, Either A File Or A Growing Memory Buffer
+struct savepng_sink {
+    FILE * fp;
+    unsigned char * data;
+    size_t len, cap;
+};
+
+static int savepng_encode(const vglImageData *image, struct savepng_sink *sink, const vglPngOptions *options);
+
+// Saves `image` (Its First Mip, Tightly Packed Rows) As A PNG File.
+// 16-Bit Samples Are Written As Stored, Big-Endian, Which Is How loadpng() Returns Them.
+int savepng(const vglImageData * image, char * filename, const vglPngOptions * options) {
+    struct savepng_sink sink;
+    memset(&sink, 0, sizeof(sink));
+    if((sink.fp = fopen(filename, "wb")) == NULL)
+        return SAVEPNG_WRITE_ERROR;
+    int res = savepng_encode(image, &sink, options);
+    if(fclose(sink.fp) && !res)
+        res = SAVEPNG_WRITE_ERROR;
+    return res;
+}
+
+// Encodes `image` Into A malloc()ed Buffer, Returned Through `buffer` And `size`.
+int savepng_mem(const vglImageData * image, void ** buffer, size_t * size, const vglPngOptions * options) {
+    struct savepng_sink sink;
+    memset(&sink, 0, sizeof(sink));
+    int res = savepng_encode(image, &sink, options);
+    if(res) {
+        free(sink.data);
+        return res;
+    }
+    *buffer = sink.data;
+    *size = sink.len;
+    return 0;
+}
+
+static int savepng_write(struct savepng_sink * sink, const void * data, size_t len) {
+    if(sink->fp)
+        return fwrite(data, 1, len, sink->fp) == len ? 0 : SAVEPNG_WRITE_ERROR;
+
+    if(sink->len + len > sink->cap) {
+        size_t cap = sink->cap ? sink->cap : 4096;
+        while(cap < sink->len + len)
+            cap *= 2;
+        unsigned char * data = (unsigned char *) realloc(sink->data, cap);
+        if( !data )
+            return SAVEPNG_OUT_OF_MEM_ERROR;
+        sink->data = data;
+        sink->cap = cap;
+    }
+    memcpy(sink->data + sink->len, data, len);
+    sink->len += len;
+    return 0;
+}
+
+static void savepng_put_uint32(unsigned char * buf, uint32_t value) {
+    buf[0] = value >> 24;
+    buf[1] = value >> 16;
+    buf[2] = value >> 8;
+    buf[3] = value;
+}
+
+// Writes One PNG Chunk (Length, Type, Data, CRC)
+static int savepng_write_chunk(struct savepng_sink * sink, const char * type, const void * data, size_t len) {
+    unsigned char head[8], crc[4];
+    savepng_put_uint32(head, (uint32_t) len);
+    memcpy(head + 4, type, 4);
+    uLong sum = crc32(crc32(0L, Z_NULL, 0), head + 4, 4);
+    if(len)
+        sum = crc32(sum, (const Bytef *) data, len); // crc32() Resets On A NULL Buffer
+    savepng_put_uint32(crc, sum);
+
+    int res;
+    if((res = savepng_write(sink, head, 8)) || (len && (res = savepng_write(sink, data, len))))
+        return res;
+    return savepng_write(sink, crc, 4);
+}
+
+// Applies One Filter To Row `y`. `dst` Gets The Filter Byte Followed By `rowbytes` Filtered Bytes.
+static void savepng_apply_filter(const struct savepng_state * state, int filter, GLsizei y, Bytef * dst) {
+    const GLubyte * row = state->pixels + (size_t) y * state->rowbytes;
+    const GLubyte * prior = y > 0 ? row - state->rowbytes : NULL;
+    size_t i, n = state->rowbytes;
+    int bpp = state->bpp;
+
+    // Row 0 Has An All-Zero Prior Row, Which Turns Up Into None And Paeth Into Sub
+    if(!prior && (filter == VGL_PNG_FILTER_UP || filter == VGL_PNG_FILTER_PAETH))
+        filter = filter == VGL_PNG_FILTER_UP ? VGL_PNG_FILTER_NONE : VGL_PNG_FILTER_SUB;
+
+    *dst++ = (Bytef) filter;
+    switch (filter) {
+        case VGL_PNG_FILTER_NONE:
+            memcpy(dst, row, n);
+            break;
+        case VGL_PNG_FILTER_SUB:
+            memcpy(dst, row, bpp);
+            for(i = bpp; i < n; ++i)
+                dst[i] = row[i] - row[i - bpp];
+            break;
+        case VGL_PNG_FILTER_UP:
+            for(i = 0; i < n; ++i)
+                dst[i] = row[i] - prior[i];
+            break;
+        case VGL_PNG_FILTER_AVG:
+            for(i = 0; i < n; ++i) {
+                int a = i >= (size_t) bpp ? row[i - bpp] : 0, b = prior ? prior[i] : 0;
+                dst[i] = row[i] - ((a + b) >> 1);
+            }
+            break;
+        case VGL_PNG_FILTER_PAETH:
+            for(i = 0; i < (size_t) bpp; ++i)
+                dst[i] = row[i] - prior[i];
+            for(; i < n; ++i) {
+                int a = row[i - bpp], b = prior[i], c = prior[i - bpp];
+                int p = b - c, q = a - c;
+                int pa = abs(p), pb = abs(q), pc = abs(p + q);
+                dst[i] = row[i] - ((pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c);
+            }
+            break;
+    }
+}
+
+// Filters Row `y` Into `dst` (rowbytes + 1 Bytes). Adaptive Filtering Uses libpng's Heuristic (Smallest Sum Of |Signed Bytes|)
+// And Needs `trial` As Scratch. The First Row Of A Restart Segment Is Limited To None/Sub So It Doesn't Need The Row Above.
+static void savepng_filter_row(const struct savepng_state * state, GLsizei y, Bytef * dst, Bytef * trial) {
+    int restricted = state->restarts && y % state->chunk_rows == 0;
+    if(state->filter != VGL_PNG_FILTER_ADAPTIVE) {
+        int filter = state->filter;
+        if(restricted && filter > VGL_PNG_FILTER_SUB)
+            filter = VGL_PNG_FILTER_SUB;
+        savepng_apply_filter(state, filter, y, dst);
+        return;
+    }
+
+    unsigned long best = (unsigned long) -1;
+    int filter, last = restricted ? VGL_PNG_FILTER_SUB : VGL_PNG_FILTER_PAETH;
+    for(filter = VGL_PNG_FILTER_NONE; filter <= last; ++filter) {
+        savepng_apply_filter(state, filter, y, trial);
+        unsigned long sum = 0;
+        for(size_t i = 1; i <= state->rowbytes && sum < best; ++i)
+            sum += trial[i] < 128 ? trial[i] : 256 - trial[i];
+        if(sum < best) {
+            best = sum;
+            memcpy(dst, trial, state->rowbytes + 1);
+        }
+    }
+}
+
+// Job: Filters And Deflates One Chunk Of Rows Into A Raw Deflate Fragment Ending On A Byte Boundary (Z_SYNC_FLUSH),
+// Except The Last Chunk Which Finishes The Stream. Without Restarts The Dictionary Is Primed With The Tail Of The
+// Previous Chunk (Re-Filtered Here) So Matches Can Still Reach Back Across The Chunk Boundary.
+static int savepng_chunk_job(void * user, size_t chunk) {
+    struct savepng_state * state = (struct savepng_state *) user;
+    struct savepng_chunk * out = &state->out[chunk];
+    GLsizei first = (GLsizei) chunk * state->chunk_rows;
+    GLsizei last = first + state->chunk_rows < state->height ? first + state->chunk_rows : state->height;
+    size_t line = state->rowbytes + 1;
+    int is_last = chunk == state->chunks - 1;
+
+    Bytef * filtered = (Bytef *) malloc(line * 2);
+    if( !filtered )
+        return SAVEPNG_OUT_OF_MEM_ERROR;
+    Bytef * trial = filtered + line;
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    if(deflateInit2(&strm, state->level, Z_DEFLATED, -15, 8, state->filter == VGL_PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED) != Z_OK) {
+        free(filtered);
+        return SAVEPNG_OUT_OF_MEM_ERROR;
+    }
+
+    int res = 0;
+    if(chunk > 0 && !state->restarts && state->level > 0) {
+        GLsizei tail = (GLsizei) ((VGL_PNG_WINDOW + line - 1) / line);
+        GLsizei from = first - tail > 0 ? first - tail : 0;
+        size_t dict_len = (size_t) (first - from) * line;
+        Bytef * dict = (Bytef *) malloc(dict_len);
+        if( !dict )
+            res = SAVEPNG_OUT_OF_MEM_ERROR;
+        else {
+            for(GLsizei y = from; y < first; ++y)
+                savepng_filter_row(state, y, dict + (size_t) (y - from) * line, trial);
+            size_t used = dict_len > VGL_PNG_WINDOW ? VGL_PNG_WINDOW : dict_len;
+            deflateSetDictionary(&strm, dict + dict_len - used, used);
+            free(dict);
+        }
+    }
+
+    out->raw_len = (size_t) (last - first) * line;
+    size_t head = chunk == 0 ? 2 : 0, trail = is_last ? 4 : 0;
+    size_t cap = deflateBound(&strm, out->raw_len) + 16; // Room For The Flush Marker Too
+    if(!res && (out->data = (Bytef *) malloc(head + cap + trail)) == NULL)
+        res = SAVEPNG_OUT_OF_MEM_ERROR;
+
+    if( !res ) {
+        strm.next_out = out->data + head;
+        strm.avail_out = cap;
+        out->adler = adler32(0L, Z_NULL, 0);
+        for(GLsizei y = first; y < last && !res; ++y) {
+            savepng_filter_row(state, y, filtered, trial);
+            out->adler = adler32(out->adler, filtered, line);
+            strm.next_in = filtered;
+            strm.avail_in = line;
+            int z = deflate(&strm, y == last - 1 ? (is_last ? Z_FINISH : Z_SYNC_FLUSH) : Z_NO_FLUSH);
+            if(z == Z_STREAM_ERROR || strm.avail_in != 0 || (y == last - 1 && is_last && z != Z_STREAM_END))
+                res = SAVEPNG_DEFLATE_ERROR;
+        }
+        out->len = head + (cap - strm.avail_out);
+    }
+
+    deflateEnd(&strm);
+    free(filtered);
+    return res;
+}
+
+// Maps The Image Format Back To A PNG Color Type/Bit Depth, Compresses The Chunks In Parallel And Writes The File.
+static int savepng_encode(const vglImageData * image, struct savepng_sink * sink, const vglPngOptions * options) {
+    vglPngOptions defaults = { VGL_PNG_DEFAULT_LEVEL, VGL_PNG_FILTER_ADAPTIVE, 0, 0 };
+    if( !options )
+        options = &defaults;
+    if(!image || !image->mip[0].data || image->mip[0].width <= 0 || image->mip[0].height <= 0)
+        return IMAGE_DOESNT_EXIST_ERROR;
+
+    int color_type, bit_depth;
+    switch (image->format) {
+        case GL_RED: case GL_R: color_type = 0; break;
+        case GL_RG: color_type = 4; break;
+        case GL_RGB: color_type = 2; break;
+        case GL_RGBA: color_type = 6; break;
+        default: return SAVEPNG_UNSUPPORTED_FORMAT_ERROR;
+    }
+    switch (image->type) {
+        case GL_UNSIGNED_BYTE: bit_depth = 8; break;
+        case GL_UNSIGNED_SHORT: bit_depth = 16; break;
+        default: return SAVEPNG_UNSUPPORTED_FORMAT_ERROR;
+    }
+    if(options->level < 0 || options->level > 9 || options->filter < VGL_PNG_FILTER_NONE || options->filter > VGL_PNG_FILTER_ADAPTIVE)
+        return SAVEPNG_UNSUPPORTED_FORMAT_ERROR;
+
+    struct savepng_state state;
+    state.pixels = (const GLubyte *) image->mip[0].data;
+    state.bpp = vglPixelSize(image);
+    state.rowbytes = (size_t) image->mip[0].width * state.bpp;
+    state.height = image->mip[0].height;
+    state.level = options->level;
+    state.filter = options->filter;
+    state.restarts = options->restarts;
+    state.chunk_rows = options->chunkRows > 0 ? options->chunkRows : (GLsizei) (VGL_PNG_CHUNK_BYTES / (state.rowbytes + 1) + 1);
+    if((state.height + state.chunk_rows - 1) / state.chunk_rows > VGL_PNG_MAX_CHUNKS)
+        state.chunk_rows = (state.height + VGL_PNG_MAX_CHUNKS - 1) / VGL_PNG_MAX_CHUNKS;
+    state.chunks = (state.height + state.chunk_rows - 1) / state.chunk_rows;
+    if((state.out = (struct savepng_chunk *) calloc(state.chunks, sizeof(*state.out))) == NULL)
+        return SAVEPNG_OUT_OF_MEM_ERROR;
+
+    int res = vglParallelFor(state.chunks, savepng_chunk_job, &state);
+
+    // Stitch The zlib Stream: Header In Front Of The First Chunk, Combined Adler-32 After The Last One
+    size_t i;
+    if( !res ) {
+        int flevel = state.level < 2 ? 0 : state.level < 6 ? 1 : state.level == 6 ? 2 : 3;
+        unsigned cmf = 0x78, flg = flevel << 6;
+        flg += 31 - (cmf * 256 + flg) % 31;
+        state.out[0].data[0] = cmf;
+        state.out[0].data[1] = flg;
+
+        uLong adler = adler32(0L, Z_NULL, 0);
+        for(i = 0; i < state.chunks; ++i)
+            adler = adler32_combine(adler, state.out[i].adler, state.out[i].raw_len);
+        struct savepng_chunk * tail = &state.out[state.chunks - 1];
+        savepng_put_uint32(tail->data + tail->len, adler);
+        tail->len += 4;
+    }
+
+    // Signature, IHDR, sRGB, Restarts, One IDAT Per Chunk, IEND
+    if( !res ) {
+        static const unsigned char sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+        unsigned char ihdr[13];
+        savepng_put_uint32(ihdr, image->mip[0].width);
+        savepng_put_uint32(ihdr + 4, image->mip[0].height);
+        ihdr[8] = bit_depth;
+        ihdr[9] = color_type;
+        ihdr[10] = ihdr[11] = ihdr[12] = 0; // Deflate, Adaptive Filtering, No Interlace
+        if(!(res = savepng_write(sink, sig, 8)))
+            res = savepng_write_chunk(sink, "IHDR", ihdr, 13);
+        // sRGB Formats Get An sRGB Chunk (Perceptual Intent) So They Load Back As sRGB
+        if(!res && (image->internalFormat == GL_SRGB8 || image->internalFormat == GL_SRGB8_ALPHA8)) {
+            static const unsigned char intent = 0;
+            res = savepng_write_chunk(sink, "sRGB", &intent, 1);
+        }
+    }
+    if(!res && state.restarts) {
+        size_t len = 4 + 8 * state.chunks, offset = 2;
+        unsigned char * payload = (unsigned char *) malloc(len);
+        if( !payload )
+            res = SAVEPNG_OUT_OF_MEM_ERROR;
+        else {
+            savepng_put_uint32(payload, state.chunks);
+            for(i = 0; i < state.chunks; ++i) {
+                savepng_put_uint32(payload + 4 + 8 * i, (uint32_t) (i * state.chunk_rows));
+                savepng_put_uint32(payload + 8 + 8 * i, (uint32_t) offset);
+                offset += state.out[i].len - (i == 0 ? 2 : 0);
+            }
+            if(offset > 0xFFFFFFFFu) // Offsets Are 32-Bit, Such A File Just Can't Have Restarts
+                res = SAVEPNG_UNSUPPORTED_FORMAT_ERROR;
+            else
+                res = savepng_write_chunk(sink, "vgRS", payload, len);
+            free(payload);
+        }
+    }
+    for(i = 0; i < state.chunks && !res; ++i)
+        res = savepng_write_chunk(sink, "IDAT", state.out[i].data, state.out[i].len);
+    if( !res )
+        res = savepng_write_chunk(sink, "IEND", NULL, 0);
+
+    for(i = 0; i < state.chunks; ++i)
+        free(state.out[i].data);
+    free(state.out);
+    return res;
+}
@@ -0,0 +1,282 @@
+// Decoded Images Shared Between Processes On The Same Host (POSIX Shared Memory, Needs -pthread, And -lrt On Old glibc).
+// Every Version Of A File (Device, Inode, Modification Time And Size) Gets A Named Segment In /dev/shm. The First Process
+// To Load It Decodes Straight Into The Segment, Every Other One Maps The Decoded Pixels Read-Only Instead Of Decoding Again,
+// And They All Share The Same Physical Pages.
+// Protocol: The Segment Is Opened (Or Created), Then Write-Locked (Open File Description Locks, Which Also Keep Threads
+// Of One Process Apart, So Loads Of Different Images Run In Parallel). Whoever Holds The Lock Either Finds A Complete
+// Segment And Maps It, Or Decodes Into It And Marks It Complete Last. A Decoder That Dies Leaves An Incomplete Segment
+// Behind, Which The Next Process Decodes Again. Segments Outlive The Processes, Drop Them With vglSharedRemove().
+// When No Segment Can Be Used (/dev/shm Full Or Missing, A Segment Owned By Another User, ...) The Image Is Decoded
+// Into Private Memory Instead, vglSharedUnload() Releases Either Kind.
+# ifndef _LIIMAGE
+    # include "loadimage.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdio.h>
+# include <stdlib.h>
+# include <stdint.h>
+# include <string.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <pthread.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+
+// Linux Only Declares The Open File Description Locks Under _GNU_SOURCE. Kernels Older Than 3.15 Reject Them,
+// Which Ends Up In The Private Decode.
+# ifndef F_OFD_SETLK
+    # define F_OFD_SETLK 37
+# endif
+# ifndef F_OFD_SETLKW
+    # define F_OFD_SETLKW 38
+# endif
+
+# define _LISHARED 1
+
+# define VGL_SHARED_MAGIC "VGLSHM1"
+# define VGL_SHARED_HEADER 4096 // Header Page, The Pixels Start On The Next One
+# ifndef VGL_SHARED_MODE
+    # define VGL_SHARED_MODE 0600 // Segments Are Only Shared Between Processes Of The Same User
+# endif
+
+// Errors
+# define SHARED_STAT_ERROR 0x1200 // The Image File Can't Be stat()ed
+# define SHARED_OPEN_ERROR 0x1201 // shm_open() Or Locking Failed
+# define SHARED_MAP_ERROR 0x1202
+# define VGL_SHARED_FAILED(res) ((res) >= SHARED_STAT_ERROR && (res) <= SHARED_MAP_ERROR) // Worth Falling Back To A Private Decode
+
+// Segment Header (Native Byte Order, Every Process Runs On The Same Host)
+struct vgl_shared_header {
+    char magic[8];
+    uint32_t ready; // Set Last, Once The Pixels Are Complete
+    uint32_t width, height;
+    uint32_t format, type, internalFormat;
+    uint64_t size; // Of The Pixels
+    uint64_t dev, ino, size_on_disk; // The File Version It Was Decoded From
+    int64_t mtime_sec, mtime_nsec;
+};
+
+// Functions
+int vglSharedLoad(char *filename, vglImageData *out);
+int vglSharedUnload(vglImageData *image);
+int vglSharedRemove(char *filename);
+static int vgl_shared_load(char *filename, const char *name, const struct vgl_shared_header *key, vglImageData *out);
+
+// Guards vgl_shared_mappings Only, The Segments Themselves Are Locked Per Open Descriptor
+static pthread_mutex_t vgl_shared_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// The Segments This Process Has Mapped. Pixels Not Listed Here Were Decoded Privately.
+struct vgl_shared_mapping {
+    void * data;
+    size_t length; // Of The Whole Mapping, Header Page Included
+    struct vgl_shared_mapping * next;
+};
+static struct vgl_shared_mapping * vgl_shared_mappings = NULL;
+
+// Segment Name And Identity Of The File's Current Version
+static int vgl_shared_key(const char * filename, char name[32], struct vgl_shared_header * key) {
+    struct stat st;
+    if(stat(filename, &st) != 0)
+        return SHARED_STAT_ERROR;
+    memset(key, 0, sizeof(*key));
+    key->dev = (uint64_t) st.st_dev;
+    key->ino = (uint64_t) st.st_ino;
+    key->size_on_disk = (uint64_t) st.st_size;
+    key->mtime_sec = (int64_t) st.st_mtim.tv_sec;
+    key->mtime_nsec = (int64_t) st.st_mtim.tv_nsec;
+
+    // FNV-1a Over The Identity
+    uint64_t fields[5] = { key->dev, key->ino, key->size_on_disk, (uint64_t) key->mtime_sec, (uint64_t) key->mtime_nsec };
+    const unsigned char * p = (const unsigned char *) fields;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < sizeof(fields); ++i)
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    snprintf(name, 32, "/vglimage-%016llx", (unsigned long long) h);
+    return 0;
+}
+
+static int vgl_shared_same_file(const struct vgl_shared_header * a, const struct vgl_shared_header * b) {
+    return a->dev == b->dev && a->ino == b->ino && a->size_on_disk == b->size_on_disk &&
+           a->mtime_sec == b->mtime_sec && a->mtime_nsec == b->mtime_nsec;
+}
+
+// Decoder Writing Into The Segment
+struct vgl_shared_writer {
+    int fd;
+    unsigned char * base; // The Whole Segment, Mapped Writable
+    size_t length;
+    vglImageData * out;
+};
+
+static int vgl_shared_row(void * user, const vglImageData * image, GLsizei y, const GLvoid * row) {
+    struct vgl_shared_writer * writer = (struct vgl_shared_writer *) user;
+    size_t rowbytes = (size_t) image->mip[0].width * vglPixelSize(image);
+    if(y == 0) {
+        *writer->out = *image;
+        writer->out->TextureTotalSize = (GLsizeiptr) (rowbytes * image->mip[0].height);
+        writer->length = VGL_SHARED_HEADER + rowbytes * image->mip[0].height;
+        // Reserve The Pages Now: Writing Past What A Full /dev/shm Can Hold Would Be A SIGBUS, Not An Error
+        if(posix_fallocate(writer->fd, 0, (off_t) writer->length) != 0)
+            return SHARED_MAP_ERROR;
+        void * base = mmap(NULL, writer->length, PROT_READ | PROT_WRITE, MAP_SHARED, writer->fd, 0);
+        if(base == MAP_FAILED)
+            return SHARED_MAP_ERROR;
+        writer->base = (unsigned char *) base;
+    }
+    memcpy(writer->base + VGL_SHARED_HEADER + (size_t) y * rowbytes, row, rowbytes);
+    return 0;
+}
+
+// Maps A Complete Segment Read-Only, Or Returns Non-Zero If It Isn't One (Or Belongs To Another File)
+static int vgl_shared_attach(int fd, const struct vgl_shared_header * key, vglImageData * out) {
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t) st.st_size < VGL_SHARED_HEADER)
+        return 1;
+    void * base = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if(base == MAP_FAILED)
+        return 1;
+    const struct vgl_shared_header * header = (const struct vgl_shared_header *) base;
+    if(memcmp(header->magic, VGL_SHARED_MAGIC, 8) != 0 || !header->ready || !vgl_shared_same_file(header, key) ||
+       header->size != (uint64_t) st.st_size - VGL_SHARED_HEADER) {
+        munmap(base, (size_t) st.st_size);
+        return 1;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->target = GL_TEXTURE_2D;
+    out->mipmapCount = 1;
+    out->mip[0].width = (GLsizei) header->width;
+    out->mip[0].height = (GLsizei) header->height;
+    out->format = header->format;
+    out->type = header->type;
+    out->internalFormat = header->internalFormat;
+    out->TextureTotalSize = (GLsizeiptr) header->size;
+    out->mip[0].data = (unsigned char *) base + VGL_SHARED_HEADER;
+    return 0;
+}
+
+// Decodes The File Into The Segment, Called With It Locked
+static int vgl_shared_decode(int fd, char * filename, const char * name, const struct vgl_shared_header * key, vglImageData * out) {
+    struct vgl_shared_writer writer = { fd, NULL, 0, out };
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    int res;
+    if(ftruncate(fd, 0) != 0)
+        res = SHARED_MAP_ERROR;
+    else
+        res = vglLoadRows(filename, &info, vgl_shared_row, &writer);
+    if( !res && !writer.base )
+        res = SHARED_MAP_ERROR;
+    if( !res ) {
+        struct vgl_shared_header * header = (struct vgl_shared_header *) writer.base;
+        *header = *key;
+        memcpy(header->magic, VGL_SHARED_MAGIC, 8);
+        header->width = (uint32_t) out->mip[0].width;
+        header->height = (uint32_t) out->mip[0].height;
+        header->format = out->format;
+        header->type = out->type;
+        header->internalFormat = out->internalFormat;
+        header->size = (uint64_t) out->TextureTotalSize;
+        header->ready = 1; // Readers Only Look Under The Lock, Which Orders This After The Pixels
+        mprotect(writer.base, writer.length, PROT_READ);
+        out->mipmapCount = 1;
+        out->mip[0].data = writer.base + VGL_SHARED_HEADER;
+    } else {
+        if(writer.base)
+            munmap(writer.base, writer.length);
+        out->mip[0].data = NULL;
+        shm_unlink(name); // Nothing Worth Sharing
+    }
+    return res;
+}
+
+// Loads An Image Through The Host-Wide Shared Segments: Maps The Pixels Another Process Already Decoded,
+// Or Decodes Them For Everyone. Falls Back To vglLoad() When The Segment Can't Be Used.
+// `out->mip[0].data` Is Read-Only, Release It With vglSharedUnload().
+int vglSharedLoad(char * filename, vglImageData * out) {
+    if( !out )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    out->mip[0].data = NULL;
+
+    char name[32];
+    struct vgl_shared_header key;
+    int res = vgl_shared_key(filename, name, &key);
+    if( !res )
+        res = vgl_shared_load(filename, name, &key, out);
+    if(VGL_SHARED_FAILED(res))
+        res = vglLoad(filename, out); // A Cache Miss Isn't A Reason To Fail
+    return res;
+}
+
+// Maps Or Decodes The Segment Called `name`
+static int vgl_shared_load(char * filename, const char * name, const struct vgl_shared_header * key, vglImageData * out) {
+    struct vgl_shared_mapping * mapping = (struct vgl_shared_mapping *) malloc(sizeof(*mapping));
+    if( !mapping )
+        return SHARED_MAP_ERROR;
+
+    int fd = shm_open(name, O_RDWR | O_CREAT, VGL_SHARED_MODE);
+    if(fd < 0) {
+        free(mapping);
+        return SHARED_OPEN_ERROR;
+    }
+    struct flock lock;
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET; // l_pid Stays 0, As Open File Description Locks Require
+    if(fcntl(fd, F_OFD_SETLKW, &lock) != 0) {
+        close(fd);
+        free(mapping);
+        return SHARED_OPEN_ERROR;
+    }
+
+    // Someone Else Decoded It Already, Or It's Our Turn (Starting Over In Case A Decoder Died Halfway)
+    int res = 0;
+    if(vgl_shared_attach(fd, key, out) != 0)
+        res = vgl_shared_decode(fd, filename, name, key, out);
+    if( !res ) {
+        mapping->data = out->mip[0].data;
+        mapping->length = VGL_SHARED_HEADER + (size_t) out->TextureTotalSize;
+        pthread_mutex_lock(&vgl_shared_lock);
+        mapping->next = vgl_shared_mappings;
+        vgl_shared_mappings = mapping;
+        pthread_mutex_unlock(&vgl_shared_lock);
+    } else
+        free(mapping);
+
+    lock.l_type = F_UNLCK;
+    fcntl(fd, F_OFD_SETLK, &lock);
+    close(fd); // The Mapping Keeps The Segment Alive
+    return res;
+}
+
+// Unmaps A Shared Image, Or Frees One vglSharedLoad() Had To Decode Privately
+int vglSharedUnload(vglImageData * image) {
+    if( !image || !image->mip[0].data )
+        return 0;
+    pthread_mutex_lock(&vgl_shared_lock);
+    struct vgl_shared_mapping ** link = &vgl_shared_mappings;
+    while(*link && (*link)->data != image->mip[0].data)
+        link = &(*link)->next;
+    struct vgl_shared_mapping * mapping = *link;
+    if(mapping)
+        *link = mapping->next;
+    pthread_mutex_unlock(&vgl_shared_lock);
+
+    if(mapping) {
+        munmap((unsigned char *) mapping->data - VGL_SHARED_HEADER, mapping->length);
+        free(mapping);
+    } else
+        free(image->mip[0].data);
+    image->mip[0].data = NULL;
+    return 0;
+}
+
+// Removes The Segment Of The File's Current Version. Processes That Mapped It Keep Their Pixels,
+// The Memory Is Freed Once The Last One Unloads. The Next vglSharedLoad() Decodes Again.
+int vglSharedRemove(char * filename) {
+    char name[32];
+    struct vgl_shared_header key;
+    int res = vgl_shared_key(filename, name, &key);
+    if(res)
+        return res;
+    return shm_unlink(name) == 0 ? 0 : SHARED_OPEN_ERROR;
+}
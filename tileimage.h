@@ -0,0 +1,148 @@
+// Tile-Major Output For Virtual/Sparse Texturing.
+// Images Are Cut Into Fixed-Size Tiles (With Borders Copied From The Neighbouring Tiles) While The Decoder Streams Rows,
+// So The Row-Major Image Is Never Stored.
+# ifndef _LIIMAGE
+    # include "loadimage.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdlib.h>
+# include <string.h>
+
+# define _LITILE 1
+
+// Errors
+# define TILE_ILLEGAL_SIZE_ERROR 0x900
+# define TILE_OUT_OF_MEM_ERROR 0x901
+
+// Tile Index. Tile (tx, ty) Lives At data + offsets[ty * tilesX + tx].
+typedef struct {
+    GLsizei tileSize; // Tile Content Size In Pixels (e.g. 128)
+    GLsizei border; // Border Around Each Tile In Pixels (e.g. 4)
+    GLsizei tilesX, tilesY; // Tile Count Per Row / Column
+    GLsizei imageWidth, imageHeight; // Size Of The Source Image
+    GLsizeiptr tileBytes; // Size Of One Tile (Borders Included) In Bytes
+    GLsizeiptr * offsets; // Byte Offset Of Every Tile, Tile-Major
+} vglTileIndex;
+
+// Functions
+int vglLoadTiled(char *filename, GLsizei tile_size, GLsizei border, vglImageData *out, vglTileIndex *index);
+int vglUnloadTiled(vglImageData *image, vglTileIndex *index);
+int vglTileRow(void * user, const vglImageData * image, GLsizei y, const GLvoid * row);
+
+// State Of A Tiling Pass
+struct vgl_tiler {
+    vglImageData * out;
+    vglTileIndex * index;
+};
+
+// Loads An Image As A Set Of (tile_size + 2 * border)^2 Tiles Stored One After Another.
+// `out` Describes The Tiles As A GL_TEXTURE_2D_ARRAY (One Slice Per Tile), `index` Maps Tiles To Their Offsets.
+// Pixels Past The Image Edges (Borders And The Last Partial Tiles) Repeat The Edge Pixels.
+int vglLoadTiled(char * filename, GLsizei tile_size, GLsizei border, vglImageData * out, vglTileIndex * index) {
+    if( !out || !index )
+        return IMAGE_DOESNT_EXIST_ERROR;
+    if(tile_size <= 0 || border < 0 || border > tile_size)
+        return TILE_ILLEGAL_SIZE_ERROR;
+
+    struct vgl_tiler tiler = { out, index };
+    vglImageData info;
+    memset(&info, 0, sizeof(info));
+    memset(index, 0, sizeof(*index));
+    index->tileSize = tile_size;
+    index->border = border;
+    out->mip[0].data = NULL;
+
+    int res = vglLoadRows(filename, &info, vglTileRow, &tiler);
+    if(res)
+        vglUnloadTiled(out, index);
+    return res;
+}
+
+int vglUnloadTiled(vglImageData * image, vglTileIndex * index) {
+    if( image ) {
+        free(image->mip[0].data);
+        image->mip[0].data = NULL;
+    }
+    if( index ) {
+        free(index->offsets);
+        index->offsets = NULL;
+    }
+    return 0;
+}
+
+// Row Callback That Scatters Each Image Row Into Every Tile Row It Belongs To (At Most Two Tile Bands When border <= tileSize).
+// Expects `index->tileSize` And `index->border` To Be Set, Allocates The Tiles On The First Row.
+int vglTileRow(void * user, const vglImageData * image, GLsizei y, const GLvoid * row) {
+    struct vgl_tiler * tiler = (struct vgl_tiler *) user;
+    vglTileIndex * index = tiler->index;
+    vglImageData * out = tiler->out;
+    GLsizei T = index->tileSize, B = index->border, span = T + 2 * B;
+    GLsizei width = image->mip[0].width, height = image->mip[0].height;
+    size_t ps = vglPixelSize(image);
+
+    if(y == 0) {
+        index->imageWidth = width;
+        index->imageHeight = height;
+        index->tilesX = (width + T - 1) / T;
+        index->tilesY = (height + T - 1) / T;
+        index->tileBytes = (GLsizeiptr) span * span * ps;
+
+        size_t count = (size_t) index->tilesX * index->tilesY;
+        index->offsets = (GLsizeiptr *) malloc(count * sizeof(*index->offsets));
+        *out = *image;
+        out->target = GL_TEXTURE_2D_ARRAY;
+        out->mipmapCount = 1;
+        out->slices = count;
+        out->SliceStride = index->tileBytes;
+        out->TextureTotalSize = index->tileBytes * count;
+        out->mip[0].width = span;
+        out->mip[0].height = span;
+        out->mip[0].depth = 0;
+        out->mip[0].mipStride = 0;
+        if(!index->offsets || (out->mip[0].data = malloc(out->TextureTotalSize)) == NULL)
+            return TILE_OUT_OF_MEM_ERROR;
+        for(size_t i = 0; i < count; ++i)
+            index->offsets[i] = (GLsizeiptr) i * index->tileBytes;
+    }
+
+    const GLubyte * src = (const GLubyte *) row;
+    size_t line = (size_t) span * ps;
+
+    // Tile Bands Whose Rows (Borders Included) Cover `y`: ty * T - B <= y < ty * T + T + B.
+    GLsizei ty_first = y < B ? 0 : (y - B) / T;
+    GLsizei ty_last = (y + B) / T;
+    if(ty_last >= index->tilesY)
+        ty_last = index->tilesY - 1;
+
+    for(GLsizei ty = ty_first; ty <= ty_last; ++ty) {
+        GLsizei band_top = ty * T - B; // Image Row Of The Tile's First Row
+        GLsizei r_first = y - band_top, r_last = r_first;
+        if(y == 0)
+            r_first = 0; // Top Border Repeats Row 0
+        if(y == height - 1)
+            r_last = span - 1; // Bottom Border (And Missing Rows) Repeat The Last Row
+        if(r_first < 0) r_first = 0;
+        if(r_last >= span) r_last = span - 1;
+        if(r_first > r_last)
+            continue;
+
+        for(GLsizei tx = 0; tx < index->tilesX; ++tx) {
+            GLubyte * tile = (GLubyte *) out->mip[0].data + index->offsets[ty * index->tilesX + tx];
+            GLubyte * dst = tile + (size_t) r_first * line;
+            GLsizei left = tx * T - B, x0 = left < 0 ? 0 : left;
+            GLsizei right = left + span, x1 = right > width ? width : right;
+            GLsizei px = 0;
+
+            // Left Clamp, Then The Pixels Inside The Image, Then Right Clamp
+            for(; px < x0 - left; ++px)
+                memcpy(dst + px * ps, src, ps);
+            memcpy(dst + px * ps, src + (size_t) x0 * ps, (size_t) (x1 - x0) * ps);
+            px += x1 - x0;
+            for(; px < span; ++px)
+                memcpy(dst + px * ps, src + (size_t) (width - 1) * ps, ps);
+
+            for(GLsizei r = r_first + 1; r <= r_last; ++r)
+                memcpy(tile + (size_t) r * line, dst, line);
+        }
+    }
+    return 0;
+}
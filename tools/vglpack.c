@@ -0,0 +1,45 @@
+// Packs Images Into An Archive For packfile.h
+// Build : cc -O2 -pthread -I.. vglpack.c -o vglpack -lpng -ljpeg -lz
+// Usage : vglpack [-d] [-C dir] archive.vpk image...
+//      -d      Store Images Decoded Instead Of As Their PNG/JPEG/QOI Bytes
+//      -C dir  Name Entries Relative To `dir` (Files Are Still Opened As Given)
+# include "../packfile.h" // First, It Sets Up The POSIX Feature Macros
+
+int main(int argc, char ** argv) {
+    int decode = 0, arg = 1;
+    const char * root = NULL;
+    for(; arg < argc && argv[arg][0] == '-'; ++arg) {
+        if(strcmp(argv[arg], "-d") == 0)
+            decode = 1;
+        else if(strcmp(argv[arg], "-C") == 0 && arg + 1 < argc)
+            root = argv[++arg];
+        else
+            break;
+    }
+    if(argc - arg < 2) {
+        fprintf(stderr, "Usage : %s [-d] [-C dir] archive.vpk image...\n", argv[0]);
+        return 1;
+    }
+
+    const char * archive = argv[arg++];
+    int count = argc - arg;
+    const char ** names = (const char **) malloc((size_t) count * sizeof(*names));
+    if( !names )
+        return 1;
+    size_t root_len = root ? strlen(root) : 0;
+    for(int i = 0; i < count; ++i) {
+        const char * name = argv[arg + i];
+        if(root && strncmp(name, root, root_len) == 0) {
+            name += root_len;
+            while(*name == '/')
+                ++name;
+        }
+        names[i] = name;
+    }
+
+    int res = vglPackBuild(archive, argv + arg, names, count, decode);
+    if(res)
+        fprintf(stderr, "%s : Packing Failed (0x%X)\n", archive, res);
+    free(names);
+    return res ? 1 : 0;
+}
@@ -0,0 +1,327 @@
+// Asynchronous Texture Uploads Through A Ring Of Persistently Mapped Pixel Buffer Objects (Needs OpenGL 4.4 Or ARB_buffer_storage).
+// Pixels Are Copied Into A Free PBO Slot And Uploaded From There, So glTexSubImage* Returns Without Waiting For The Copy,
+// And A Fence Per Slot Tells Us When The GPU Is Done With It. Textures Get Immutable Storage (glTexStorage*).
+# ifndef _LIIMAGE
+    # include "loadimage.h" // First: It Sets Up The Feature-Test Macros Before Any System Header
+# endif
+# include <stdint.h>
+# include <stdlib.h>
+# include <string.h>
+# include <GL/gl.h>
+# include <GL/glext.h>
+
+# define _LIUPLOAD 1
+
+# define VGL_MAX_UPLOAD_SLOTS 8
+# define VGL_UPLOAD_DEFAULT_SLOTS 3
+# define VGL_UPLOAD_DEFAULT_SLOT_SIZE (4 << 20)
+
+// Errors
+# define UPLOAD_MISSING_GL_ERROR 0xB00 // The Context Lacks An Entry Point We Need
+# define UPLOAD_GL_ERROR 0xB01
+# define UPLOAD_SLOT_TOO_SMALL_ERROR 0xB02 // A Single Row Doesn't Fit In A Slot
+# define UPLOAD_UNSUPPORTED_TARGET_ERROR 0xB03
+
+// Returns The Address Of A GL Function (eglGetProcAddress, glXGetProcAddress, SDL_GL_GetProcAddress, ...)
+typedef void * (*vglGetProcAddress)(const char * name);
+
+// PBO Ring. GL 1.1 Functions Are Called Directly, Newer Ones Through The Pointers Below.
+typedef struct {
+    int slots; // Number Of PBOs In The Ring
+    GLsizeiptr slotSize; // Size Of Each PBO In Bytes
+    int next; // Next Slot To Fill
+    GLuint buffers[VGL_MAX_UPLOAD_SLOTS];
+    GLubyte * mapped[VGL_MAX_UPLOAD_SLOTS]; // Persistent, Coherent Write Mappings
+    GLsync fences[VGL_MAX_UPLOAD_SLOTS]; // Signaled Once The GPU Has Consumed The Slot
+
+    PFNGLGENBUFFERSPROC GenBuffers;
+    PFNGLDELETEBUFFERSPROC DeleteBuffers;
+    PFNGLBINDBUFFERPROC BindBuffer;
+    PFNGLBUFFERSTORAGEPROC BufferStorage;
+    PFNGLMAPBUFFERRANGEPROC MapBufferRange;
+    PFNGLUNMAPBUFFERPROC UnmapBuffer;
+    PFNGLFENCESYNCPROC FenceSync;
+    PFNGLCLIENTWAITSYNCPROC ClientWaitSync;
+    PFNGLDELETESYNCPROC DeleteSync;
+    PFNGLTEXSTORAGE2DPROC TexStorage2D;
+    PFNGLTEXSTORAGE3DPROC TexStorage3D;
+    PFNGLTEXSUBIMAGE3DPROC TexSubImage3D;
+} vglUploader;
+
+// Functions
+int vglUploaderInit(vglUploader *uploader, vglGetProcAddress get_proc, int slots, GLsizeiptr slot_size);
+int vglUploaderDestroy(vglUploader *uploader);
+int vglUploadTexture(vglUploader *uploader, const vglImageData *image, GLuint *texture);
+int vglUploadFile(vglUploader *uploader, char *filename, GLsizei levels, GLuint *texture, vglImageData *info);
+
+// The Caller's Unpack State, Restored After Every Upload
+struct vgl_unpack_state {
+    GLint alignment, swap, row_length, skip_rows, skip_pixels, image_height, skip_images;
+};
+
+// State Of A Streaming Upload (vglUploadFile)
+struct vgl_upload_stream {
+    vglUploader * uploader;
+    GLsizei levels;
+    GLuint * texture;
+    GLubyte * slot; // Mapped Slot Being Filled
+    GLsizei band_y, band_rows, rows_per_slot;
+    struct vgl_unpack_state saved;
+};
+
+// Creates `slots` (0 = VGL_UPLOAD_DEFAULT_SLOTS) Persistently Mapped PBOs Of `slot_size` (0 = VGL_UPLOAD_DEFAULT_SLOT_SIZE) Bytes.
+// Needs A Current Context. Large Images Are Uploaded In Row Bands Of At Most One Slot Each.
+int vglUploaderInit(vglUploader * uploader, vglGetProcAddress get_proc, int slots, GLsizeiptr slot_size) {
+    memset(uploader, 0, sizeof(*uploader));
+    uploader->slots = slots > 0 ? (slots > VGL_MAX_UPLOAD_SLOTS ? VGL_MAX_UPLOAD_SLOTS : slots) : VGL_UPLOAD_DEFAULT_SLOTS;
+    uploader->slotSize = slot_size > 0 ? slot_size : VGL_UPLOAD_DEFAULT_SLOT_SIZE;
+
+    uploader->GenBuffers = (PFNGLGENBUFFERSPROC) get_proc("glGenBuffers");
+    uploader->DeleteBuffers = (PFNGLDELETEBUFFERSPROC) get_proc("glDeleteBuffers");
+    uploader->BindBuffer = (PFNGLBINDBUFFERPROC) get_proc("glBindBuffer");
+    uploader->BufferStorage = (PFNGLBUFFERSTORAGEPROC) get_proc("glBufferStorage");
+    uploader->MapBufferRange = (PFNGLMAPBUFFERRANGEPROC) get_proc("glMapBufferRange");
+    uploader->UnmapBuffer = (PFNGLUNMAPBUFFERPROC) get_proc("glUnmapBuffer");
+    uploader->FenceSync = (PFNGLFENCESYNCPROC) get_proc("glFenceSync");
+    uploader->ClientWaitSync = (PFNGLCLIENTWAITSYNCPROC) get_proc("glClientWaitSync");
+    uploader->DeleteSync = (PFNGLDELETESYNCPROC) get_proc("glDeleteSync");
+    uploader->TexStorage2D = (PFNGLTEXSTORAGE2DPROC) get_proc("glTexStorage2D");
+    uploader->TexStorage3D = (PFNGLTEXSTORAGE3DPROC) get_proc("glTexStorage3D");
+    uploader->TexSubImage3D = (PFNGLTEXSUBIMAGE3DPROC) get_proc("glTexSubImage3D");
+    if(!uploader->GenBuffers || !uploader->DeleteBuffers || !uploader->BindBuffer || !uploader->BufferStorage ||
+       !uploader->MapBufferRange || !uploader->UnmapBuffer || !uploader->FenceSync || !uploader->ClientWaitSync ||
+       !uploader->DeleteSync || !uploader->TexStorage2D || !uploader->TexStorage3D || !uploader->TexSubImage3D)
+        return UPLOAD_MISSING_GL_ERROR;
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    uploader->GenBuffers(uploader->slots, uploader->buffers);
+    for(int i = 0; i < uploader->slots; ++i) {
+        uploader->BindBuffer(GL_PIXEL_UNPACK_BUFFER, uploader->buffers[i]);
+        uploader->BufferStorage(GL_PIXEL_UNPACK_BUFFER, uploader->slotSize, NULL, flags);
+        uploader->mapped[i] = (GLubyte *) uploader->MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, uploader->slotSize, flags);
+        if( !uploader->mapped[i] ) {
+            uploader->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            vglUploaderDestroy(uploader);
+            return UPLOAD_GL_ERROR;
+        }
+    }
+    uploader->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return 0;
+}
+
+// Waits For Pending Uploads And Releases The Ring
+int vglUploaderDestroy(vglUploader * uploader) {
+    if( !uploader->BindBuffer )
+        return 0;
+    for(int i = 0; i < uploader->slots; ++i) {
+        if(uploader->fences[i]) {
+            uploader->ClientWaitSync(uploader->fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, (GLuint64) -1);
+            uploader->DeleteSync(uploader->fences[i]);
+            uploader->fences[i] = 0;
+        }
+        if(uploader->mapped[i]) {
+            uploader->BindBuffer(GL_PIXEL_UNPACK_BUFFER, uploader->buffers[i]);
+            uploader->UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            uploader->mapped[i] = NULL;
+        }
+    }
+    uploader->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if(uploader->buffers[0])
+        uploader->DeleteBuffers(uploader->slots, uploader->buffers);
+    memset(uploader->buffers, 0, sizeof(uploader->buffers));
+    return 0;
+}
+
+// Returns The Next Slot's Mapping Once The GPU Is Done With It. Fill It, Then Upload From It With vgl_upload_submit().
+static GLubyte * vgl_upload_acquire(vglUploader * uploader) {
+    int slot = uploader->next;
+    if(uploader->fences[slot]) {
+        GLenum status;
+        do
+            status = uploader->ClientWaitSync(uploader->fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        while(status == GL_TIMEOUT_EXPIRED);
+        uploader->DeleteSync(uploader->fences[slot]);
+        uploader->fences[slot] = 0;
+        if(status == GL_WAIT_FAILED)
+            return NULL;
+    }
+    return uploader->mapped[slot];
+}
+
+// Uploads `rows` Rows (Starting At Row `y` Of Layer `slice`) From The Current Slot, Fences It And Moves On.
+static void vgl_upload_submit(vglUploader * uploader, const vglImageData * image, GLint level, GLsizei width, GLsizei y, GLsizei rows, GLsizei slice) {
+    int slot = uploader->next;
+    uploader->BindBuffer(GL_PIXEL_UNPACK_BUFFER, uploader->buffers[slot]);
+    if(image->target == GL_TEXTURE_2D_ARRAY)
+        uploader->TexSubImage3D(image->target, level, 0, y, slice, width, rows, 1, image->format, image->type, (const GLvoid *) 0);
+    else
+        glTexSubImage2D(image->target, level, 0, y, width, rows, image->format, image->type, (const GLvoid *) 0);
+    uploader->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    uploader->fences[slot] = uploader->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    uploader->next = (slot + 1) % uploader->slots;
+}
+
+// Saves The Caller's Unpack State And Clears Anything That Would Make GL Skip Or Restride Our Tightly Packed Rows
+static void vgl_unpack_save(struct vgl_unpack_state * state) {
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &state->alignment);
+    glGetIntegerv(GL_UNPACK_SWAP_BYTES, &state->swap);
+    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &state->row_length);
+    glGetIntegerv(GL_UNPACK_SKIP_ROWS, &state->skip_rows);
+    glGetIntegerv(GL_UNPACK_SKIP_PIXELS, &state->skip_pixels);
+    glGetIntegerv(GL_UNPACK_IMAGE_HEIGHT, &state->image_height);
+    glGetIntegerv(GL_UNPACK_SKIP_IMAGES, &state->skip_images);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+    glPixelStorei(GL_UNPACK_SKIP_IMAGES, 0);
+}
+
+static void vgl_unpack_restore(const struct vgl_unpack_state * state) {
+    glPixelStorei(GL_UNPACK_ALIGNMENT, state->alignment);
+    glPixelStorei(GL_UNPACK_SWAP_BYTES, state->swap);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, state->row_length);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, state->skip_rows);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, state->skip_pixels);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, state->image_height);
+    glPixelStorei(GL_UNPACK_SKIP_IMAGES, state->skip_images);
+}
+
+// Sets The Unpack State For Our Rows: The Largest Alignment Tightly Packed Rows Satisfy (3-Byte RGB Rows Usually Need 1),
+// And Byte Swapping For 16-Bit Samples, Which The Loaders Keep Big-Endian Like PNG Does.
+static void vgl_unpack_rows(const vglImageData * image, size_t rowbytes) {
+    static const uint16_t probe = 1;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, (rowbytes % 8 == 0) ? 8 : (rowbytes % 4 == 0) ? 4 : (rowbytes % 2 == 0) ? 2 : 1);
+    glPixelStorei(GL_UNPACK_SWAP_BYTES, image->type == GL_UNSIGNED_SHORT && *(const uint8_t *) &probe == 1);
+}
+
+// Drops Errors The Caller Left Behind, So The glGetError() Checks Below Only See Ours (Bounded In Case The Context Is Lost)
+static void vgl_upload_clear_errors(void) {
+    for(int i = 0; i < 64 && glGetError() != GL_NO_ERROR; ++i);
+}
+
+// Creates And Binds An Immutable Texture For `image` With `levels` Levels.
+// Clears Stale Errors First: Both Uploads Check glGetError() Once They're Done, And This Runs Before Anything They Queue.
+static int vgl_upload_storage(vglUploader * uploader, const vglImageData * image, GLsizei levels, GLuint * texture) {
+    GLsizei layers = image->slices > 0 ? image->slices : 1;
+    if(image->target != GL_TEXTURE_2D && image->target != GL_TEXTURE_2D_ARRAY)
+        return UPLOAD_UNSUPPORTED_TARGET_ERROR;
+
+    vgl_upload_clear_errors();
+    glGenTextures(1, texture);
+    glBindTexture(image->target, *texture);
+    if(image->target == GL_TEXTURE_2D_ARRAY)
+        uploader->TexStorage3D(image->target, levels, image->internalFormat, image->mip[0].width, image->mip[0].height, layers);
+    else
+        uploader->TexStorage2D(image->target, levels, image->internalFormat, image->mip[0].width, image->mip[0].height);
+    if(glGetError() != GL_NO_ERROR) {
+        glDeleteTextures(1, texture);
+        *texture = 0;
+        return UPLOAD_GL_ERROR;
+    }
+    return 0;
+}
+
+// Uploads Every Mip And Slice Of `image` Into A New Immutable Texture (Left Bound), Going Through The PBO Ring In Row Bands.
+// Returns Once The Copies Are Queued. `image` Can Be Freed Right Away.
+int vglUploadTexture(vglUploader * uploader, const vglImageData * image, GLuint * texture) {
+    GLsizei levels = image->mipmapCount > 0 ? image->mipmapCount : 1;
+    GLsizei layers = image->slices > 0 ? image->slices : 1;
+    size_t ps = vglPixelSize(image);
+    int res;
+    if((res = vgl_upload_storage(uploader, image, levels, texture)))
+        return res;
+
+    struct vgl_unpack_state saved;
+    vgl_unpack_save(&saved);
+    for(GLint level = 0; level < levels && !res; ++level) {
+        const vglImageMipData * mip = &image->mip[level];
+        size_t rowbytes = (size_t) mip->width * ps;
+        size_t slice_stride = (level == 0 && image->SliceStride) ? (size_t) image->SliceStride : rowbytes * mip->height;
+        GLsizei rows_per_slot = (GLsizei) (uploader->slotSize / rowbytes);
+        if(rows_per_slot == 0) {
+            res = UPLOAD_SLOT_TOO_SMALL_ERROR;
+            break;
+        }
+        vgl_unpack_rows(image, rowbytes);
+
+        for(GLsizei slice = 0; slice < layers && !res; ++slice) {
+            const GLubyte * src = (const GLubyte *) mip->data + slice * slice_stride;
+            for(GLsizei y = 0; y < mip->height; y += rows_per_slot) {
+                GLsizei rows = mip->height - y < rows_per_slot ? mip->height - y : rows_per_slot;
+                GLubyte * dst = vgl_upload_acquire(uploader);
+                if( !dst ) {
+                    res = UPLOAD_GL_ERROR;
+                    break;
+                }
+                memcpy(dst, src + (size_t) y * rowbytes, (size_t) rows * rowbytes);
+                vgl_upload_submit(uploader, image, level, mip->width, y, rows, slice);
+            }
+        }
+    }
+    vgl_unpack_restore(&saved);
+    if(!res && glGetError() != GL_NO_ERROR)
+        res = UPLOAD_GL_ERROR;
+    if(res) {
+        glDeleteTextures(1, texture);
+        *texture = 0;
+    }
+    return res;
+}
+
+// Row Callback That Writes Decoded Rows Straight Into The Mapped Slots And Uploads Each Slot As It Fills Up
+static int vgl_upload_row(void * user, const vglImageData * image, GLsizei y, const GLvoid * row) {
+    struct vgl_upload_stream * stream = (struct vgl_upload_stream *) user;
+    vglUploader * uploader = stream->uploader;
+    size_t rowbytes = (size_t) image->mip[0].width * vglPixelSize(image);
+    int res;
+
+    if(y == 0) {
+        if((stream->rows_per_slot = (GLsizei) (uploader->slotSize / rowbytes)) == 0)
+            return UPLOAD_SLOT_TOO_SMALL_ERROR;
+        if(stream->levels <= 0) { // Full Chain, So glGenerateMipmap() Works Afterwards
+            GLsizei size = image->mip[0].width > image->mip[0].height ? image->mip[0].width : image->mip[0].height;
+            for(stream->levels = 1; size > 1; size >>= 1)
+                ++stream->levels;
+        }
+        if((res = vgl_upload_storage(uploader, image, stream->levels, stream->texture)))
+            return res;
+        vgl_unpack_rows(image, rowbytes);
+        stream->band_y = 0;
+        stream->band_rows = 0;
+    }
+
+    if(stream->band_rows == 0 && (stream->slot = vgl_upload_acquire(uploader)) == NULL)
+        return UPLOAD_GL_ERROR;
+    memcpy(stream->slot + (size_t) stream->band_rows * rowbytes, row, rowbytes);
+
+    if(++stream->band_rows == stream->rows_per_slot || y == image->mip[0].height - 1) {
+        vgl_upload_submit(uploader, image, 0, image->mip[0].width, stream->band_y, stream->band_rows, 0);
+        stream->band_y += stream->band_rows;
+        stream->band_rows = 0;
+    }
+    return 0;
+}
+
+// Decodes A File Straight Into The PBO Ring And Uploads It Band By Band As The Rows Come Out Of The Decoder,
+// So The Whole Image Never Sits In Client Memory. `levels` Is The Number Of Levels To Allocate (0 = Full Chain, Only Level 0 Is Filled).
+// `info` Receives The Image Info (Without Data).
+int vglUploadFile(vglUploader * uploader, char * filename, GLsizei levels, GLuint * texture, vglImageData * info) {
+    struct vgl_upload_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.uploader = uploader;
+    stream.levels = levels;
+    stream.texture = texture;
+    *texture = 0;
+    vgl_unpack_save(&stream.saved);
+
+    int res = vglLoadRows(filename, info, vgl_upload_row, &stream);
+    vgl_unpack_restore(&stream.saved);
+    if(!res && glGetError() != GL_NO_ERROR)
+        res = UPLOAD_GL_ERROR;
+    if(res && *texture) {
+        glDeleteTextures(1, texture);
+        *texture = 0;
+    }
+    return res;
+}
@@ -0,0 +1,233 @@
+// C++17 Layer Over The Loaders. vgl::Image Owns The Pixels Of A vglImageData (Move-Only, Freed By Its Deleter),
+// Hands Out Views Instead Of Copies, And vgl::load() Reports Errors Through An expected-Like Result Instead Of Out-Parameters.
+# include <cstddef>
+# include <cstdlib>
+# include <new>
+# include <string>
+# include <utility>
+# include <type_traits>
+
+# if defined(__has_include)
+    # if __has_include(<version>)
+        # include <version>
+    # endif
+# endif
+# if defined(__cpp_lib_span)
+    # include <span>
+# endif
+# if defined(__cpp_lib_expected)
+    # include <expected>
+# endif
+
+# ifndef _LIIMAGE
+    # include "loadimage.h"
+# endif
+
+# define _LIIMAGEXX 1
+
+namespace vgl {
+
+// Contiguous View. std::span When The Standard Library Has It.
+# if defined(__cpp_lib_span)
+template <typename T> using Span = std::span<T>;
+# else
+template <typename T>
+class Span {
+public:
+    constexpr Span() noexcept = default;
+    constexpr Span(T * data, std::size_t size) noexcept : data_(data), size_(size) {}
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U> & other) noexcept : data_(other.data()), size_(other.size()) {}
+
+    constexpr T * data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr std::size_t size_bytes() const noexcept { return size_ * sizeof(T); }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr T * begin() const noexcept { return data_; }
+    constexpr T * end() const noexcept { return data_ + size_; }
+    constexpr T & operator[](std::size_t i) const noexcept { return data_[i]; }
+    constexpr Span subspan(std::size_t offset, std::size_t count) const noexcept { return Span(data_ + offset, count); }
+
+private:
+    T * data_ = nullptr;
+    std::size_t size_ = 0;
+};
+# endif
+
+// Error Code Returned By The C Loaders (BAD_SIG_ERROR, JPEG_READ_ERROR, UNKNOWN_IMAGE_FORMAT_ERROR, ...)
+struct Error {
+    int code;
+};
+
+// Result Of A Load. std::expected When The Standard Library Has It.
+# if defined(__cpp_lib_expected)
+template <typename T, typename E> using Expected = std::expected<T, E>;
+template <typename E> inline std::unexpected<E> unexpected(E error) { return std::unexpected<E>(std::move(error)); }
+# else
+template <typename E>
+struct Unexpected {
+    E error;
+};
+template <typename E> inline Unexpected<E> unexpected(E error) { return Unexpected<E>{ std::move(error) }; }
+
+template <typename T, typename E>
+class Expected {
+public:
+    Expected(T && value) : ok_(true) { new (&value_) T(std::move(value)); }
+    Expected(Unexpected<E> && error) : ok_(false) { new (&error_) E(std::move(error.error)); }
+    Expected(Expected && other) noexcept : ok_(other.ok_) { take(std::move(other)); }
+    Expected & operator=(Expected && other) noexcept {
+        if(this != &other) {
+            destroy();
+            ok_ = other.ok_;
+            take(std::move(other));
+        }
+        return *this;
+    }
+    ~Expected() { destroy(); }
+
+    bool has_value() const noexcept { return ok_; }
+    explicit operator bool() const noexcept { return ok_; }
+    T & value() & { return value_; }
+    const T & value() const & { return value_; }
+    T && value() && { return std::move(value_); }
+    const E & error() const { return error_; }
+    T & operator*() & { return value_; }
+    T && operator*() && { return std::move(value_); }
+    T * operator->() { return &value_; }
+    const T * operator->() const { return &value_; }
+
+private:
+    void take(Expected && other) noexcept {
+        if(ok_) new (&value_) T(std::move(other.value_));
+        else new (&error_) E(std::move(other.error_));
+    }
+    void destroy() noexcept {
+        if(ok_) value_.~T();
+        else error_.~E();
+    }
+
+    bool ok_;
+    union {
+        T value_;
+        E error_;
+    };
+};
+# endif
+
+// Owns The Pixels Of A vglImageData. The Deleter Is Any Of The C unload Functions (unloadpng, vglUnloadMapped, ...),
+// The Default One free()s mip[0].data, Which Is What Every Loader Allocates.
+class Image {
+public:
+    using Deleter = int (*)(vglImageData *);
+
+    static int freeData(vglImageData * image) {
+        std::free(image->mip[0].data);
+        image->mip[0].data = nullptr;
+        return 0;
+    }
+
+    Image() noexcept : data_(), deleter_(nullptr) {}
+    // Takes Ownership Of `data`'s Pixels
+    explicit Image(const vglImageData & data, Deleter deleter = freeData) noexcept : data_(data), deleter_(deleter) {}
+    Image(Image && other) noexcept : data_(other.data_), deleter_(other.deleter_) { other.forget(); }
+    Image & operator=(Image && other) noexcept {
+        if(this != &other) {
+            reset();
+            data_ = other.data_;
+            deleter_ = other.deleter_;
+            other.forget();
+        }
+        return *this;
+    }
+    Image(const Image &) = delete;
+    Image & operator=(const Image &) = delete;
+    ~Image() { reset(); }
+
+    explicit operator bool() const noexcept { return data_.mip[0].data != nullptr; }
+    const vglImageData & info() const noexcept { return data_; }
+    GLsizei width(GLint level = 0) const noexcept { return data_.mip[level].width; }
+    GLsizei height(GLint level = 0) const noexcept { return data_.mip[level].height; }
+    GLsizei levels() const noexcept { return data_.mipmapCount > 0 ? (GLsizei) data_.mipmapCount : 1; }
+    GLsizei layers() const noexcept { return data_.slices > 0 ? data_.slices : 1; }
+    std::size_t pixelSize() const noexcept { return (std::size_t) vglPixelSize(&data_); }
+    std::size_t rowBytes(GLint level = 0) const noexcept { return (std::size_t) data_.mip[level].width * pixelSize(); }
+
+    // Every Layer Of A Mip Level
+    Span<std::byte> mip(GLint level = 0) noexcept { return Span<std::byte>((std::byte *) data_.mip[level].data, mipBytes(level)); }
+    Span<const std::byte> mip(GLint level = 0) const noexcept { return Span<const std::byte>((const std::byte *) data_.mip[level].data, mipBytes(level)); }
+    // One Layer Of A Mip Level (Texture Arrays, Tiles)
+    Span<std::byte> slice(GLsizei layer, GLint level = 0) noexcept { return mip(level).subspan((std::size_t) layer * sliceStride(level), layerBytes(level)); }
+    Span<const std::byte> slice(GLsizei layer, GLint level = 0) const noexcept { return mip(level).subspan((std::size_t) layer * sliceStride(level), layerBytes(level)); }
+    // One Row Of A Layer
+    Span<std::byte> row(GLsizei y, GLsizei layer = 0, GLint level = 0) noexcept { return slice(layer, level).subspan((std::size_t) y * rowBytes(level), rowBytes(level)); }
+    Span<const std::byte> row(GLsizei y, GLsizei layer = 0, GLint level = 0) const noexcept { return slice(layer, level).subspan((std::size_t) y * rowBytes(level), rowBytes(level)); }
+
+    // Gives Up Ownership. The Caller Frees The Result.
+    vglImageData release() noexcept {
+        vglImageData data = data_;
+        forget();
+        return data;
+    }
+    void reset() noexcept {
+        if(deleter_ && data_.mip[0].data)
+            deleter_(&data_);
+        forget();
+    }
+
+private:
+    void forget() noexcept {
+        data_ = vglImageData();
+        deleter_ = nullptr;
+    }
+    std::size_t layerBytes(GLint level) const noexcept {
+        std::size_t depth = data_.mip[level].depth > 0 ? (std::size_t) data_.mip[level].depth : 1;
+        return rowBytes(level) * (std::size_t) data_.mip[level].height * depth;
+    }
+    std::size_t sliceStride(GLint level) const noexcept {
+        return (level == 0 && data_.SliceStride) ? (std::size_t) data_.SliceStride : layerBytes(level);
+    }
+    std::size_t mipBytes(GLint level) const noexcept {
+        if(level == 0 && levels() == 1 && data_.TextureTotalSize)
+            return (std::size_t) data_.TextureTotalSize;
+        return sliceStride(level) * (std::size_t) (layers() - 1) + layerBytes(level);
+    }
+
+    vglImageData data_;
+    Deleter deleter_;
+};
+
+// Loads Any Supported Image From A File
+inline Expected<Image, Error> load(const std::string & path) {
+    vglImageData data = vglImageData();
+    if(int res = vglLoad(const_cast<char *>(path.c_str()), &data))
+        return vgl::unexpected(Error{ res });
+    return Image(data);
+}
+
+// Loads Any Supported Image From Memory (The Bytes Are Only Read During The Call)
+inline Expected<Image, Error> load(Span<const std::byte> bytes) {
+    vglImageData data = vglImageData();
+    if(int res = vglLoadMemory(bytes.data(), bytes.size(), &data))
+        return vgl::unexpected(Error{ res });
+    return Image(data);
+}
+
+inline Expected<Image, Error> loadRegion(const std::string & path, GLsizei x, GLsizei y, GLsizei width, GLsizei height) {
+    vglImageData data = vglImageData();
+    if(int res = vglLoadRegion(const_cast<char *>(path.c_str()), x, y, width, height, &data))
+        return vgl::unexpected(Error{ res });
+    return Image(data);
+}
+
+# ifdef _LIMAP
+// Out-Of-Core Load (See mapimage.h). The Image Unmaps Itself.
+inline Expected<Image, Error> loadMapped(const std::string & path, const char * target = nullptr) {
+    vglImageData data = vglImageData();
+    if(int res = vglLoadMapped(const_cast<char *>(path.c_str()), const_cast<char *>(target), &data))
+        return vgl::unexpected(Error{ res });
+    return Image(data, vglUnloadMapped);
+}
+# endif
+
+} // namespace vgl